@@ -0,0 +1,114 @@
+#include "FuzzPerfGuard.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> gAllocatedBytes { 0 };
+
+bool perfModeEnabled()
+{
+    static const bool enabled = [] {
+        const char *env = std::getenv("KONFLIKT_FUZZ_PERF");
+        return env && *env && *env != '0';
+    }();
+    return enabled;
+}
+
+double perfScale()
+{
+    static const double scale = [] {
+        const char *env = std::getenv("KONFLIKT_FUZZ_PERF_SCALE");
+        double value = env ? std::atof(env) : 0.0;
+        return value > 0.0 ? value : 1.0;
+    }();
+    return scale;
+}
+
+} // namespace
+
+// Count every allocation so perf mode can compare memory use to input size
+void *operator new(size_t size)
+{
+    gAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace konflikt::fuzz {
+
+uint64_t allocatedBytes()
+{
+    return gAllocatedBytes.load(std::memory_order_relaxed);
+}
+
+PerfGuard::PerfGuard(const char *target, size_t inputSize)
+    : mTarget(target)
+    , mInputSize(inputSize)
+    , mEnabled(perfModeEnabled())
+{
+    if (mEnabled) {
+        mStartAllocated = allocatedBytes();
+        mStart = std::chrono::steady_clock::now();
+    }
+}
+
+PerfGuard::~PerfGuard()
+{
+    if (!mEnabled) {
+        return;
+    }
+
+    double elapsedNs = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                               std::chrono::steady_clock::now() - mStart)
+                                               .count());
+    double allocated = static_cast<double>(allocatedBytes() - mStartAllocated);
+    double size = static_cast<double>(mInputSize);
+    double scale = perfScale();
+
+    double timeBudget = (BASE_NS + NS_PER_BYTE * size) * scale;
+    double allocBudget = (BASE_ALLOC_BYTES + ALLOC_BYTES_PER_BYTE * size) * scale;
+
+    if (elapsedNs > timeBudget) {
+        std::fprintf(stderr, "%s: super-linear time: %.0fns for %zu bytes (budget %.0fns)\n",
+                     mTarget, elapsedNs, mInputSize, timeBudget);
+        std::abort();
+    }
+    if (allocated > allocBudget) {
+        std::fprintf(stderr, "%s: super-linear allocation: %.0f bytes for %zu input bytes (budget %.0f)\n",
+                     mTarget, allocated, mInputSize, allocBudget);
+        std::abort();
+    }
+}
+
+} // namespace konflikt::fuzz
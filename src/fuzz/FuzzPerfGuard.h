@@ -0,0 +1,41 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace konflikt::fuzz {
+
+/// Bytes allocated through operator new since process start (see FuzzPerfGuard.cpp)
+uint64_t allocatedBytes();
+
+/// Perf-fuzz mode: flags inputs whose cost grows super-linearly with their size
+///
+/// Enabled by setting KONFLIKT_FUZZ_PERF=1. Each input gets a time and
+/// allocation budget that is linear in the input size; exceeding it aborts
+/// so libFuzzer saves the input as a crash. Budgets can be scaled with
+/// KONFLIKT_FUZZ_PERF_SCALE (default 1.0) to account for sanitizer overhead.
+class PerfGuard
+{
+public:
+    PerfGuard(const char *target, size_t inputSize);
+    ~PerfGuard();
+
+    PerfGuard(const PerfGuard &) = delete;
+    PerfGuard &operator=(const PerfGuard &) = delete;
+
+    /// Per-byte and fixed budgets
+    static constexpr double NS_PER_BYTE = 2000.0;
+    static constexpr double BASE_NS = 2'000'000.0;
+    static constexpr double ALLOC_BYTES_PER_BYTE = 64.0;
+    static constexpr double BASE_ALLOC_BYTES = 256.0 * 1024.0;
+
+private:
+    const char *mTarget;
+    size_t mInputSize;
+    bool mEnabled;
+    std::chrono::steady_clock::time_point mStart;
+    uint64_t mStartAllocated { 0 };
+};
+
+} // namespace konflikt::fuzz
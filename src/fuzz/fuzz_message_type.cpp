@@ -0,0 +1,17 @@
+// libFuzzer target for getMessageType, which runs on every received message
+
+#include "FuzzPerfGuard.h"
+
+#include <konflikt/Protocol.h>
+
+using namespace konflikt;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    fuzz::PerfGuard guard("message_type", size);
+
+    std::string_view json(reinterpret_cast<const char *>(data), size);
+    auto type = getMessageType(json);
+    (void)type;
+    return 0;
+}
@@ -0,0 +1,59 @@
+// libFuzzer target for fromJson<T> on every protocol message type
+//
+// Inputs that parse must survive a serialize/parse round trip.
+
+#include "FuzzPerfGuard.h"
+
+#include <konflikt/Protocol.h>
+
+#include <cstdlib>
+
+using namespace konflikt;
+
+namespace {
+
+template <typename T>
+void fuzzMessage(std::string_view json)
+{
+    auto message = fromJson<T>(json);
+    if (!message) {
+        return;
+    }
+
+    std::string serialized = toJson(*message);
+    if (serialized.empty() || !fromJson<T>(serialized)) {
+        std::abort();
+    }
+}
+
+template <typename... Ts>
+void fuzzMessages(std::string_view json)
+{
+    (fuzzMessage<Ts>(json), ...);
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    fuzz::PerfGuard guard("protocol_json", size);
+
+    std::string_view json(reinterpret_cast<const char *>(data), size);
+    fuzzMessages<
+        HandshakeRequest,
+        HandshakeResponse,
+        InputEventMessage,
+        ClientRegistrationMessage,
+        ScreenGeometryUpdateMessage,
+        InstanceInfoMessage,
+        LayoutAssignmentMessage,
+        LayoutUpdateMessage,
+        ActivateClientMessage,
+        DeactivationRequestMessage,
+        HeartbeatMessage,
+        StateResetMessage,
+        UpdateRequiredMessage,
+        ClipboardSyncMessage,
+        ServerShutdownMessage>(json);
+    return 0;
+}
@@ -0,0 +1,70 @@
+// libFuzzer target for the WebSocket client frame parser
+//
+// Byte 0 selects the mode: bit 0 parses an HTTP upgrade response first, the
+// remaining bits pick the chunk size used to feed the rest of the input, so
+// frames get split across reads the way they are on a real socket.
+
+#include "FuzzPerfGuard.h"
+#include "WebSocketFrame.h"
+
+#include <cstdlib>
+
+using namespace konflikt;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    if (size < 1) {
+        return 0;
+    }
+
+    fuzz::PerfGuard guard("websocket_frame", size);
+
+    bool withHandshake = (data[0] & 0x01) != 0;
+    size_t chunkSize = static_cast<size_t>(data[0] >> 1) + 1;
+    const char *input = reinterpret_cast<const char *>(data + 1);
+    size_t remaining = size - 1;
+
+    WebSocketFrameParser parser;
+    WebSocketFrame frame;
+    bool handshakeDone = !withHandshake;
+    size_t fed = 0;
+
+    while (remaining > 0) {
+        size_t length = remaining < chunkSize ? remaining : chunkSize;
+        parser.append(input, length);
+        input += length;
+        remaining -= length;
+        fed += length;
+
+        // The parser never holds more than it was given
+        if (parser.buffered() > fed) {
+            std::abort();
+        }
+
+        if (!handshakeDone) {
+            HandshakeParseResult result = parser.parseHandshake();
+            if (result == HandshakeParseResult::Rejected) {
+                return 0;
+            }
+            if (result == HandshakeParseResult::NeedMore) {
+                continue;
+            }
+            handshakeDone = true;
+        }
+
+        while (true) {
+            FrameParseResult result = parser.next(frame);
+            if (result == FrameParseResult::Error) {
+                return 0;
+            }
+            if (result == FrameParseResult::NeedMore) {
+                break;
+            }
+            if (frame.payload.size() > WebSocketFrameParser::MAX_PAYLOAD_SIZE) {
+                std::abort();
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+
+namespace konflikt {
+
+/// Retry delays: capped exponential backoff with decorrelated jitter
+///
+/// Each delay is drawn uniformly from [base, 3 x previous delay] and capped,
+/// so clients that lost the same server spread out instead of retrying in
+/// lockstep. The first delay after reset() is drawn from [0, base], so
+/// recovery from a brief outage stays well under a second.
+class Backoff
+{
+public:
+    static constexpr uint64_t DEFAULT_BASE_MS = 100;
+    static constexpr uint64_t DEFAULT_CAP_MS = 30000;
+
+    explicit Backoff(uint64_t baseMs = DEFAULT_BASE_MS, uint64_t capMs = DEFAULT_CAP_MS);
+
+    /// Delay before the next attempt
+    uint64_t next();
+
+    /// Start over, e.g. after a successful connection
+    void reset();
+
+    /// Attempts since the last reset
+    uint64_t attempts() const { return mAttempts; }
+
+private:
+    uint64_t mBaseMs;
+    uint64_t mCapMs;
+    uint64_t mPreviousMs { 0 };
+    uint64_t mAttempts { 0 };
+    std::mt19937_64 mRandom;
+};
+
+} // namespace konflikt
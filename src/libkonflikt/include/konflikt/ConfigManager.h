@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Konflikt.h"
+#include "ServerCache.h"
 
 #include <optional>
 #include <string>
@@ -32,11 +33,23 @@ public:
     static std::optional<Config> load(const std::string &path = "");
 
     /// Save configuration to file
+    /// Written to a temporary file and renamed into place, so a crash never
+    /// leaves a truncated config behind.
     /// @param config Configuration to save
     /// @param path Path to config file (or empty for default)
     /// @return true if successful
     static bool save(const Config &config, const std::string &path = "");
 
+    /// Get the runtime state file path (next to the user config, state.json)
+    /// Holds what the client learned at runtime, such as the servers it knows.
+    static std::string getStatePath();
+
+    /// Load the discovered-server cache (empty if there is none)
+    static std::vector<CachedServer> loadServerCache(const std::string &path = "");
+
+    /// Persist the discovered-server cache for the next start
+    static bool saveServerCache(const std::vector<CachedServer> &servers, const std::string &path = "");
+
     /// Merge command-line options with loaded config
     /// Command-line options take precedence over config file
     static Config merge(const Config &fileConfig, const Config &cmdLineConfig);
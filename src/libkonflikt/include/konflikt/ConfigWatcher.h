@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+
+namespace konflikt {
+
+/// Watches the config file for changes made outside Konflikt
+///
+/// Watches the file's directory rather than the file itself, so editors and
+/// ConfigManager::save() replacing it by rename are seen too. Linux uses
+/// inotify, macOS a kqueue vnode filter. Like NetworkMonitor it is polled and
+/// needs no thread of its own.
+class ConfigWatcher
+{
+public:
+    ConfigWatcher() = default;
+    ~ConfigWatcher();
+
+    // Non-copyable
+    ConfigWatcher(const ConfigWatcher &) = delete;
+    ConfigWatcher &operator=(const ConfigWatcher &) = delete;
+
+    /// Start watching path; returns false if changes can't be observed here
+    bool start(const std::string &path);
+
+    /// Stop watching
+    void stop();
+
+    /// Check whether the file may have changed since the last call (non-blocking)
+    bool poll();
+
+    const std::string &path() const { return mPath; }
+
+private:
+    std::string mPath;
+    std::string mFileName;
+    int mHandle { -1 };     // inotify instance on Linux, kqueue on macOS
+    int mDirectory { -1 };  // Watch descriptor on Linux, directory fd on macOS
+    int mFile { -1 };       // macOS: the file itself, for writes in place
+};
+
+} // namespace konflikt
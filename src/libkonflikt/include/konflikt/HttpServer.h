@@ -1,7 +1,6 @@
 #pragma once
 
 #include <functional>
-#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -30,41 +29,36 @@ struct HttpResponse
 /// Route handler callback
 using RouteHandler = std::function<HttpResponse(const HttpRequest &request)>;
 
-/// HTTP server using uWebSockets
+/// HTTP routes and static files for the API and UI
+///
+/// Not a server of its own: the routes are served from the WebSocket server's
+/// app and event loop (see WebSocketServer::setHttpServer), so HTTP and /ws
+/// share one port and one network thread.
 class HttpServer
 {
 public:
-    explicit HttpServer(int port);
-    ~HttpServer();
+    HttpServer() = default;
 
     // Non-copyable
     HttpServer(const HttpServer &) = delete;
     HttpServer &operator=(const HttpServer &) = delete;
 
-    /// Add a route handler
+    /// Add a route handler (before the WebSocket server starts)
     void route(const std::string &method, const std::string &path, RouteHandler handler);
 
     /// Serve static files from a directory
     void serveStatic(const std::string &urlPrefix, const std::string &directory);
 
-    /// Start the server (non-blocking)
-    bool start();
+    /// Registered routes, keyed by "METHOD /path"
+    const std::unordered_map<std::string, RouteHandler> &routes() const { return mRoutes; }
 
-    /// Stop the server
-    void stop();
+    const std::string &staticPrefix() const { return mStaticPrefix; }
 
-    /// Get the actual port
-    int port() const { return mPort; }
-
-    /// Check if running
-    bool isRunning() const { return mRunning; }
+    /// Response for a URL under staticPrefix()
+    HttpResponse serveStaticFile(const std::string &urlPath) const;
 
 private:
-    struct Impl;
-    std::unique_ptr<Impl> mImpl;
-
-    int mPort;
-    bool mRunning { false };
+    std::unordered_map<std::string, RouteHandler> mRoutes;
     std::string mStaticDir;
     std::string mStaticPrefix;
 };
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Platform.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace konflikt {
+
+/// Trace file header
+/// Layout: header followed by a packed array of TraceRecord entries.
+/// Records use host byte order; traces are meant to be replayed on the
+/// same architecture they were recorded on.
+struct TraceHeader
+{
+    char magic[8];            // "KFTRACE\0"
+    uint32_t version {};
+    uint32_t recordSize {};   // sizeof(TraceRecord) at record time
+    uint64_t startTime {};    // Wall-clock time when recording started (ms)
+};
+
+/// Fixed-size trace record for a single captured event
+struct TraceRecord
+{
+    uint64_t offsetNs {};     // Capture time relative to trace start (ns)
+    uint64_t timestamp {};    // Original event timestamp
+    int32_t x {};
+    int32_t y {};
+    int32_t dx {};
+    int32_t dy {};
+    double scrollX {};
+    double scrollY {};
+    uint32_t keyboardModifiers {};
+    uint32_t mouseButtons {};
+    uint32_t keycode {};
+    uint8_t type {};
+    uint8_t textLength {};
+    uint16_t button {};
+    uint16_t hidUsage {};
+    char text[14] {};         // Key text (truncated if longer)
+};
+
+static_assert(sizeof(TraceRecord) == 80, "TraceRecord layout changed, bump TRACE_VERSION");
+
+constexpr uint32_t TRACE_VERSION = 2;
+
+/// Records the platform event stream to a compact binary trace file
+class InputTraceWriter
+{
+public:
+    InputTraceWriter() = default;
+    ~InputTraceWriter();
+
+    // Non-copyable
+    InputTraceWriter(const InputTraceWriter &) = delete;
+    InputTraceWriter &operator=(const InputTraceWriter &) = delete;
+
+    /// Create (or truncate) the trace file and write the header
+    bool open(const std::string &path);
+
+    /// Flush and close the trace file
+    void close();
+
+    /// Append an event to the trace (call from a single thread)
+    void append(const Event &event);
+
+    /// Check if a trace is being recorded
+    bool isOpen() const { return mFile != nullptr; }
+
+    /// Number of records written so far
+    uint64_t recordCount() const { return mRecordCount; }
+
+private:
+    FILE *mFile { nullptr };
+    std::chrono::steady_clock::time_point mStart;
+    uint64_t mRecordCount { 0 };
+};
+
+/// Memory-maps a trace file for replay
+class InputTraceReader
+{
+public:
+    InputTraceReader() = default;
+    ~InputTraceReader();
+
+    // Non-copyable
+    InputTraceReader(const InputTraceReader &) = delete;
+    InputTraceReader &operator=(const InputTraceReader &) = delete;
+
+    /// Map a trace file, returns false if missing or not a valid trace
+    bool open(const std::string &path);
+
+    /// Unmap the trace file
+    void close();
+
+    /// Number of complete records in the trace
+    size_t size() const { return mRecordCount; }
+
+    /// Get the header of the mapped trace
+    const TraceHeader &header() const { return *static_cast<const TraceHeader *>(mData); }
+
+    /// Get a raw record
+    const TraceRecord &record(size_t index) const;
+
+    /// Decode a record back into a platform event
+    Event event(size_t index) const;
+
+private:
+    void *mData { nullptr };
+    size_t mSize { 0 };
+    size_t mRecordCount { 0 };
+};
+
+} // namespace konflikt
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace konflikt {
+
+/// Small integer standing in for an instance ID
+///
+/// The server assigns one to itself and to each client at handshake and sends
+/// it to the client, so messages after the handshake can name instances
+/// without repeating their IDs. The low 16 bits are a slot, the high 16 bits
+/// the slot's generation, which changes whenever the slot is released, so a
+/// stale handle never matches the slot's next owner.
+using InstanceHandle = uint32_t;
+
+/// No instance
+constexpr InstanceHandle NO_INSTANCE = 0;
+
+/// Slot of a handle, for indexing flat arrays
+constexpr size_t instanceSlot(InstanceHandle handle)
+{
+    return handle & 0xFFFF;
+}
+
+/// Assigns handles to instance IDs
+///
+/// Handles are released when the instance's session ends, and their slots
+/// reused, so the registry only bounds instances known at the same time.
+class InstanceRegistry
+{
+public:
+    /// Instances that can hold a handle at once; intern() fails beyond this
+    static constexpr size_t MAX_INSTANCES = 4096;
+
+    InstanceRegistry() = default;
+
+    // Non-copyable
+    InstanceRegistry(const InstanceRegistry &) = delete;
+    InstanceRegistry &operator=(const InstanceRegistry &) = delete;
+
+    /// Handle for id, assigning one if needed; NO_INSTANCE if id is empty or the registry is full
+    InstanceHandle intern(std::string_view id);
+
+    /// Handle for id if it has one, else NO_INSTANCE
+    InstanceHandle find(std::string_view id) const;
+
+    /// Forget handle; its slot gets a new generation before it is reused
+    void release(InstanceHandle handle);
+
+    /// ID of handle (empty for NO_INSTANCE, released or unknown handles)
+    std::string id(InstanceHandle handle) const;
+
+    /// Number of handles held
+    size_t size() const;
+
+private:
+    struct Slot
+    {
+        std::string id;
+        uint16_t generation { 1 };
+        bool used { false };
+    };
+
+    // Lets find() look up a std::string_view without building a std::string
+    struct IdHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view id) const { return std::hash<std::string_view> {}(id); }
+    };
+
+    mutable std::mutex mMutex;
+    std::vector<Slot> mSlots;
+    std::vector<uint16_t> mFreeSlots;
+    std::unordered_map<std::string, InstanceHandle, IdHash, std::equal_to<>> mHandles;
+};
+
+/// Values keyed by instance handle in a flat array
+///
+/// A drop-in for the maps that used to be keyed by instance ID: lookups index
+/// the array by slot instead of hashing a string, and check the generation.
+/// Erasing does not invalidate iterators, so entries can be erased while
+/// iterating. Not thread safe.
+template <typename T>
+class InstanceTable
+{
+    struct Slot
+    {
+        InstanceHandle handle { NO_INSTANCE };
+        std::optional<T> value;
+    };
+
+public:
+    template <typename Table, typename Value>
+    class Iterator
+    {
+    public:
+        Iterator(Table *table, size_t index)
+            : mTable(table)
+            , mIndex(index)
+        {
+            skipEmpty();
+        }
+
+        std::pair<InstanceHandle, Value &> operator*() const
+        {
+            auto &slot = mTable->mSlots[mIndex];
+            return { slot.handle, *slot.value };
+        }
+
+        Iterator &operator++()
+        {
+            ++mIndex;
+            skipEmpty();
+            return *this;
+        }
+
+        bool operator==(const Iterator &other) const { return mIndex == other.mIndex; }
+
+    private:
+        void skipEmpty()
+        {
+            while (mIndex < mTable->mSlots.size() && !mTable->mSlots[mIndex].value) {
+                ++mIndex;
+            }
+        }
+
+        Table *mTable;
+        size_t mIndex;
+    };
+
+    using iterator = Iterator<InstanceTable, T>;
+    using const_iterator = Iterator<const InstanceTable, const T>;
+
+    T *find(InstanceHandle handle)
+    {
+        Slot *slot = slotFor(handle);
+        return slot ? &*slot->value : nullptr;
+    }
+
+    const T *find(InstanceHandle handle) const
+    {
+        const Slot *slot = slotFor(handle);
+        return slot ? &*slot->value : nullptr;
+    }
+
+    bool contains(InstanceHandle handle) const { return find(handle) != nullptr; }
+
+    /// Entry for handle, default-constructed if missing; replaces an entry
+    /// left behind by an earlier generation of the slot
+    T &operator[](InstanceHandle handle)
+    {
+        size_t index = instanceSlot(handle);
+        if (index >= mSlots.size()) {
+            mSlots.resize(index + 1);
+        }
+        Slot &slot = mSlots[index];
+        if (slot.value && slot.handle != handle) {
+            slot.value.reset();
+            --mSize;
+        }
+        if (!slot.value) {
+            slot.handle = handle;
+            slot.value.emplace();
+            ++mSize;
+        }
+        return *slot.value;
+    }
+
+    bool erase(InstanceHandle handle)
+    {
+        Slot *slot = slotFor(handle);
+        if (!slot) {
+            return false;
+        }
+        slot->value.reset();
+        --mSize;
+        return true;
+    }
+
+    void clear()
+    {
+        mSlots.clear();
+        mSize = 0;
+    }
+
+    size_t size() const { return mSize; }
+    bool empty() const { return mSize == 0; }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, mSlots.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, mSlots.size()); }
+
+private:
+    Slot *slotFor(InstanceHandle handle)
+    {
+        size_t index = instanceSlot(handle);
+        if (handle == NO_INSTANCE || index >= mSlots.size()) {
+            return nullptr;
+        }
+        Slot &slot = mSlots[index];
+        return slot.value && slot.handle == handle ? &slot : nullptr;
+    }
+
+    const Slot *slotFor(InstanceHandle handle) const
+    {
+        return const_cast<InstanceTable *>(this)->slotFor(handle);
+    }
+
+    std::vector<Slot> mSlots;
+    size_t mSize { 0 };
+};
+
+} // namespace konflikt
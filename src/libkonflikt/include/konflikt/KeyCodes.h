@@ -0,0 +1,256 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace konflikt {
+
+/// Platform-neutral key identification using USB HID usages (Keyboard/Keypad page 0x07)
+///
+/// Captured keys carry their HID usage on the wire. The receiving side maps
+/// it to its native keycode with a single table lookup, so Mac<->Linux pairs
+/// need no remap configuration. A usage of 0 means "unknown", in which case
+/// the raw platform keycode is used as before.
+namespace keycodes {
+
+/// Returned by the usage -> native lookups when a usage has no native key
+inline constexpr uint16_t NO_KEYCODE = 0xFFFF;
+
+struct KeyCodePair
+{
+    uint16_t usage;
+    uint16_t code;
+};
+
+/// Linux evdev keycodes (X keycode - 8), following the kernel's hid-input mapping
+inline constexpr KeyCodePair EVDEV_KEYS[] = {
+    { 0x04, 30 }, { 0x05, 48 }, { 0x06, 46 }, { 0x07, 32 }, { 0x08, 18 },   // A-E
+    { 0x09, 33 }, { 0x0A, 34 }, { 0x0B, 35 }, { 0x0C, 23 }, { 0x0D, 36 },   // F-J
+    { 0x0E, 37 }, { 0x0F, 38 }, { 0x10, 50 }, { 0x11, 49 }, { 0x12, 24 },   // K-O
+    { 0x13, 25 }, { 0x14, 16 }, { 0x15, 19 }, { 0x16, 31 }, { 0x17, 20 },   // P-T
+    { 0x18, 22 }, { 0x19, 47 }, { 0x1A, 17 }, { 0x1B, 45 }, { 0x1C, 21 },   // U-Y
+    { 0x1D, 44 },                                                           // Z
+    { 0x1E, 2 }, { 0x1F, 3 }, { 0x20, 4 }, { 0x21, 5 }, { 0x22, 6 },        // 1-5
+    { 0x23, 7 }, { 0x24, 8 }, { 0x25, 9 }, { 0x26, 10 }, { 0x27, 11 },      // 6-0
+    { 0x28, 28 },   // Enter
+    { 0x29, 1 },    // Escape
+    { 0x2A, 14 },   // Backspace
+    { 0x2B, 15 },   // Tab
+    { 0x2C, 57 },   // Space
+    { 0x2D, 12 },   // Minus
+    { 0x2E, 13 },   // Equal
+    { 0x2F, 26 },   // Left bracket
+    { 0x30, 27 },   // Right bracket
+    { 0x31, 43 },   // Backslash
+    { 0x33, 39 },   // Semicolon
+    { 0x34, 40 },   // Apostrophe
+    { 0x35, 41 },   // Grave
+    { 0x36, 51 },   // Comma
+    { 0x37, 52 },   // Period
+    { 0x38, 53 },   // Slash
+    { 0x39, 58 },   // Caps Lock
+    { 0x3A, 59 }, { 0x3B, 60 }, { 0x3C, 61 }, { 0x3D, 62 }, { 0x3E, 63 },   // F1-F5
+    { 0x3F, 64 }, { 0x40, 65 }, { 0x41, 66 }, { 0x42, 67 }, { 0x43, 68 },   // F6-F10
+    { 0x44, 87 }, { 0x45, 88 },                                             // F11-F12
+    { 0x46, 99 },   // Print Screen
+    { 0x47, 70 },   // Scroll Lock
+    { 0x48, 119 },  // Pause
+    { 0x49, 110 },  // Insert
+    { 0x4A, 102 },  // Home
+    { 0x4B, 104 },  // Page Up
+    { 0x4C, 111 },  // Delete
+    { 0x4D, 107 },  // End
+    { 0x4E, 109 },  // Page Down
+    { 0x4F, 106 },  // Right
+    { 0x50, 105 },  // Left
+    { 0x51, 108 },  // Down
+    { 0x52, 103 },  // Up
+    { 0x53, 69 },   // Num Lock
+    { 0x54, 98 },   // Keypad /
+    { 0x55, 55 },   // Keypad *
+    { 0x56, 74 },   // Keypad -
+    { 0x57, 78 },   // Keypad +
+    { 0x58, 96 },   // Keypad Enter
+    { 0x59, 79 }, { 0x5A, 80 }, { 0x5B, 81 }, { 0x5C, 75 }, { 0x5D, 76 },   // Keypad 1-5
+    { 0x5E, 77 }, { 0x5F, 71 }, { 0x60, 72 }, { 0x61, 73 }, { 0x62, 82 },   // Keypad 6-0
+    { 0x63, 83 },   // Keypad .
+    { 0x64, 86 },   // Non-US backslash
+    { 0x65, 127 },  // Application (Compose)
+    { 0x66, 116 },  // Power
+    { 0x67, 117 },  // Keypad =
+    { 0x68, 183 }, { 0x69, 184 }, { 0x6A, 185 }, { 0x6B, 186 },             // F13-F16
+    { 0x6C, 187 }, { 0x6D, 188 }, { 0x6E, 189 }, { 0x6F, 190 },             // F17-F20
+    { 0x70, 191 }, { 0x71, 192 }, { 0x72, 193 }, { 0x73, 194 },             // F21-F24
+    { 0x7F, 113 },  // Mute
+    { 0x80, 115 },  // Volume Up
+    { 0x81, 114 },  // Volume Down
+    { 0x85, 121 },  // Keypad ,
+    { 0x87, 89 },   // International1 (Ro)
+    { 0x88, 93 },   // International2 (Katakana/Hiragana)
+    { 0x89, 124 },  // International3 (Yen)
+    { 0x8A, 92 },   // International4 (Henkan)
+    { 0x8B, 94 },   // International5 (Muhenkan)
+    { 0x90, 122 },  // LANG1 (Hangeul)
+    { 0x91, 123 },  // LANG2 (Hanja)
+    { 0xE0, 29 },   // Left Control
+    { 0xE1, 42 },   // Left Shift
+    { 0xE2, 56 },   // Left Alt
+    { 0xE3, 125 },  // Left Super
+    { 0xE4, 97 },   // Right Control
+    { 0xE5, 54 },   // Right Shift
+    { 0xE6, 100 },  // Right Alt
+    { 0xE7, 126 },  // Right Super
+};
+
+/// macOS virtual keycodes (kVK_*)
+inline constexpr KeyCodePair MAC_KEYS[] = {
+    { 0x04, 0x00 }, { 0x16, 0x01 }, { 0x07, 0x02 }, { 0x09, 0x03 },   // A S D F
+    { 0x0B, 0x04 }, { 0x0A, 0x05 }, { 0x1D, 0x06 }, { 0x1B, 0x07 },   // H G Z X
+    { 0x06, 0x08 }, { 0x19, 0x09 }, { 0x64, 0x0A }, { 0x05, 0x0B },   // C V Section B
+    { 0x14, 0x0C }, { 0x1A, 0x0D }, { 0x08, 0x0E }, { 0x15, 0x0F },   // Q W E R
+    { 0x1C, 0x10 }, { 0x17, 0x11 }, { 0x1E, 0x12 }, { 0x1F, 0x13 },   // Y T 1 2
+    { 0x20, 0x14 }, { 0x21, 0x15 }, { 0x23, 0x16 }, { 0x22, 0x17 },   // 3 4 6 5
+    { 0x2E, 0x18 }, { 0x26, 0x19 }, { 0x24, 0x1A }, { 0x2D, 0x1B },   // = 9 7 -
+    { 0x25, 0x1C }, { 0x27, 0x1D }, { 0x30, 0x1E }, { 0x12, 0x1F },   // 8 0 ] O
+    { 0x18, 0x20 }, { 0x2F, 0x21 }, { 0x0C, 0x22 }, { 0x13, 0x23 },   // U [ I P
+    { 0x28, 0x24 }, { 0x0F, 0x25 }, { 0x0D, 0x26 }, { 0x34, 0x27 },   // Return L J '
+    { 0x0E, 0x28 }, { 0x33, 0x29 }, { 0x31, 0x2A }, { 0x36, 0x2B },   // K ; \ ,
+    { 0x38, 0x2C }, { 0x11, 0x2D }, { 0x10, 0x2E }, { 0x37, 0x2F },   // / N M .
+    { 0x2B, 0x30 }, { 0x2C, 0x31 }, { 0x35, 0x32 }, { 0x2A, 0x33 },   // Tab Space ` Delete
+    { 0x29, 0x35 },   // Escape
+    { 0xE7, 0x36 },   // Right Command
+    { 0xE3, 0x37 },   // Command
+    { 0xE1, 0x38 },   // Shift
+    { 0x39, 0x39 },   // Caps Lock
+    { 0xE2, 0x3A },   // Option
+    { 0xE0, 0x3B },   // Control
+    { 0xE5, 0x3C },   // Right Shift
+    { 0xE6, 0x3D },   // Right Option
+    { 0xE4, 0x3E },   // Right Control
+    { 0x6C, 0x40 },   // F17
+    { 0x63, 0x41 },   // Keypad .
+    { 0x55, 0x43 },   // Keypad *
+    { 0x57, 0x45 },   // Keypad +
+    { 0x53, 0x47 },   // Keypad Clear (Num Lock)
+    { 0x80, 0x48 },   // Volume Up
+    { 0x81, 0x49 },   // Volume Down
+    { 0x7F, 0x4A },   // Mute
+    { 0x54, 0x4B },   // Keypad /
+    { 0x58, 0x4C },   // Keypad Enter
+    { 0x56, 0x4E },   // Keypad -
+    { 0x6D, 0x4F },   // F18
+    { 0x6E, 0x50 },   // F19
+    { 0x67, 0x51 },   // Keypad =
+    { 0x62, 0x52 }, { 0x59, 0x53 }, { 0x5A, 0x54 }, { 0x5B, 0x55 },   // Keypad 0-3
+    { 0x5C, 0x56 }, { 0x5D, 0x57 }, { 0x5E, 0x58 }, { 0x5F, 0x59 },   // Keypad 4-7
+    { 0x6F, 0x5A },   // F20
+    { 0x60, 0x5B }, { 0x61, 0x5C },                                   // Keypad 8-9
+    { 0x89, 0x5D },   // JIS Yen
+    { 0x87, 0x5E },   // JIS Underscore (Ro)
+    { 0x85, 0x5F },   // JIS Keypad ,
+    { 0x3E, 0x60 },   // F5
+    { 0x3F, 0x61 },   // F6
+    { 0x40, 0x62 },   // F7
+    { 0x3C, 0x63 },   // F3
+    { 0x41, 0x64 },   // F8
+    { 0x42, 0x65 },   // F9
+    { 0x91, 0x66 },   // JIS Eisu (LANG2)
+    { 0x44, 0x67 },   // F11
+    { 0x90, 0x68 },   // JIS Kana (LANG1)
+    { 0x68, 0x69 },   // F13
+    { 0x6B, 0x6A },   // F16
+    { 0x69, 0x6B },   // F14
+    { 0x43, 0x6D },   // F10
+    { 0x65, 0x6E },   // Context Menu
+    { 0x45, 0x6F },   // F12
+    { 0x6A, 0x71 },   // F15
+    { 0x49, 0x72 },   // Help (Insert)
+    { 0x4A, 0x73 },   // Home
+    { 0x4B, 0x74 },   // Page Up
+    { 0x4C, 0x75 },   // Forward Delete
+    { 0x3D, 0x76 },   // F4
+    { 0x4D, 0x77 },   // End
+    { 0x3B, 0x78 },   // F2
+    { 0x4E, 0x79 },   // Page Down
+    { 0x3A, 0x7A },   // F1
+    { 0x50, 0x7B },   // Left
+    { 0x4F, 0x7C },   // Right
+    { 0x51, 0x7D },   // Down
+    { 0x52, 0x7E },   // Up
+};
+
+/// Build a native keycode -> usage table (0 = unknown)
+template <size_t Size, size_t N>
+constexpr std::array<uint16_t, Size> buildUsageTable(const KeyCodePair (&pairs)[N])
+{
+    std::array<uint16_t, Size> table {};
+    for (const auto &pair : pairs) {
+        table[pair.code] = pair.usage;
+    }
+    return table;
+}
+
+/// Build a usage -> native keycode table (NO_KEYCODE = unknown)
+template <size_t N>
+constexpr std::array<uint16_t, 256> buildKeycodeTable(const KeyCodePair (&pairs)[N])
+{
+    std::array<uint16_t, 256> table {};
+    for (auto &entry : table) {
+        entry = NO_KEYCODE;
+    }
+    for (const auto &pair : pairs) {
+        table[pair.usage] = pair.code;
+    }
+    return table;
+}
+
+inline constexpr auto EVDEV_TO_USAGE = buildUsageTable<256>(EVDEV_KEYS);
+inline constexpr auto USAGE_TO_EVDEV = buildKeycodeTable(EVDEV_KEYS);
+inline constexpr auto MAC_TO_USAGE = buildUsageTable<128>(MAC_KEYS);
+inline constexpr auto USAGE_TO_MAC = buildKeycodeTable(MAC_KEYS);
+
+/// True if no usage or keycode appears twice, so both directions agree
+template <size_t N>
+constexpr bool isBijective(const KeyCodePair (&pairs)[N])
+{
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = i + 1; j < N; ++j) {
+            if (pairs[i].usage == pairs[j].usage || pairs[i].code == pairs[j].code)
+                return false;
+        }
+    }
+    return true;
+}
+
+static_assert(isBijective(EVDEV_KEYS), "EVDEV_KEYS has duplicate entries");
+static_assert(isBijective(MAC_KEYS), "MAC_KEYS has duplicate entries");
+
+} // namespace keycodes
+
+/// HID usage for a Linux evdev keycode (0 if unknown)
+constexpr uint16_t hidUsageFromEvdev(uint32_t code)
+{
+    return code < keycodes::EVDEV_TO_USAGE.size() ? keycodes::EVDEV_TO_USAGE[code] : 0;
+}
+
+/// HID usage for a macOS virtual keycode (0 if unknown)
+constexpr uint16_t hidUsageFromMac(uint32_t code)
+{
+    return code < keycodes::MAC_TO_USAGE.size() ? keycodes::MAC_TO_USAGE[code] : 0;
+}
+
+/// Keycode for the platform this binary runs on (NO_KEYCODE if unknown)
+constexpr uint16_t nativeKeycodeFromHidUsage(uint16_t usage)
+{
+    if (usage >= 256) {
+        return keycodes::NO_KEYCODE;
+    }
+#ifdef __APPLE__
+    return keycodes::USAGE_TO_MAC[usage];
+#else
+    return keycodes::USAGE_TO_EVDEV[usage];
+#endif
+}
+
+} // namespace konflikt
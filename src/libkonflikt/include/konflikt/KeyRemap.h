@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace konflikt {
+
+/// A single keycode mapping
+struct KeyRemapEntry
+{
+    uint32_t from {};
+    uint32_t to {};
+};
+
+/// Built-in remap presets
+namespace keyremap {
+
+/// Mac Command -> Linux Super, Mac Option -> Linux Alt
+inline constexpr std::array<KeyRemapEntry, 4> MAC_TO_LINUX = { {
+    { 55, 133 },  // Command Left -> Super Left
+    { 54, 134 },  // Command Right -> Super Right
+    { 58, 64 },   // Option Left -> Alt Left
+    { 61, 108 },  // Option Right -> Alt Right
+} };
+
+/// Swap from/to of every entry in a preset
+template <size_t N>
+constexpr std::array<KeyRemapEntry, N> inverted(const std::array<KeyRemapEntry, N> &preset)
+{
+    std::array<KeyRemapEntry, N> result {};
+    for (size_t i = 0; i < N; ++i) {
+        result[i] = { preset[i].to, preset[i].from };
+    }
+    return result;
+}
+
+/// Linux Super -> Mac Command, Linux Alt -> Mac Option
+inline constexpr std::array<KeyRemapEntry, 4> LINUX_TO_MAC = inverted(MAC_TO_LINUX);
+
+} // namespace keyremap
+
+/// Look up a built-in preset by name ("mac-to-linux", "linux-to-mac")
+/// Returns an empty span for unknown names
+std::span<const KeyRemapEntry> keyRemapPreset(std::string_view name);
+
+/// Compiled form of Config::keyRemap
+///
+/// Keycodes below TABLE_SIZE resolve with a single array load; anything
+/// larger falls back to a sorted search. Tables are immutable once built,
+/// so readers on other threads need no locking.
+class KeyRemapTable
+{
+public:
+    static constexpr uint32_t TABLE_SIZE = 512;
+
+    /// Identity mapping
+    KeyRemapTable();
+
+    explicit KeyRemapTable(const std::unordered_map<uint32_t, uint32_t> &mappings);
+
+    /// Map a keycode, returning it unchanged when no remap applies
+    uint32_t remap(uint32_t keycode) const
+    {
+        if (keycode < TABLE_SIZE) {
+            return mTable[keycode];
+        }
+        return remapFallback(keycode);
+    }
+
+private:
+    uint32_t remapFallback(uint32_t keycode) const;
+
+    std::array<uint32_t, TABLE_SIZE> mTable;
+    std::vector<KeyRemapEntry> mFallback;  // Sorted by from
+};
+
+} // namespace konflikt
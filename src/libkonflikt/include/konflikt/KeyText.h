@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace konflikt {
+
+/// UTF-8 text produced by a key event
+///
+/// Almost every key produces at most one character, which is stored inline
+/// so key events carry their text without a heap allocation. Longer input
+/// (IME commits) falls back to a std::string.
+class KeyText
+{
+public:
+    static constexpr size_t INLINE_CAPACITY = 8;
+
+    KeyText() = default;
+    KeyText(std::string_view text) { assign(text); }
+
+    KeyText &operator=(std::string_view text)
+    {
+        assign(text);
+        return *this;
+    }
+
+    void assign(std::string_view text)
+    {
+        if (text.size() <= INLINE_CAPACITY) {
+            std::memcpy(mInline, text.data(), text.size());
+            mSize = static_cast<uint8_t>(text.size());
+            mOverflow.clear();
+        } else {
+            mSize = OVERFLOW_SIZE;
+            mOverflow.assign(text);
+        }
+    }
+
+    /// Assign from UTF-16 code units (macOS key events), converting to UTF-8
+    void assignUtf16(const char16_t *units, size_t count)
+    {
+        char buffer[INLINE_CAPACITY * 4];
+        size_t length = 0;
+        for (size_t i = 0; i < count && length + 4 <= sizeof(buffer); ++i) {
+            uint32_t cp = units[i];
+            if (cp >= 0xD800 && cp <= 0xDBFF && i + 1 < count && units[i + 1] >= 0xDC00 && units[i + 1] <= 0xDFFF) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (units[++i] - 0xDC00);
+            } else if (cp >= 0xD800 && cp <= 0xDFFF) {
+                cp = 0xFFFD;  // Unpaired surrogate
+            }
+
+            if (cp < 0x80) {
+                buffer[length++] = static_cast<char>(cp);
+            } else if (cp < 0x800) {
+                buffer[length++] = static_cast<char>(0xC0 | (cp >> 6));
+                buffer[length++] = static_cast<char>(0x80 | (cp & 0x3F));
+            } else if (cp < 0x10000) {
+                buffer[length++] = static_cast<char>(0xE0 | (cp >> 12));
+                buffer[length++] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                buffer[length++] = static_cast<char>(0x80 | (cp & 0x3F));
+            } else {
+                buffer[length++] = static_cast<char>(0xF0 | (cp >> 18));
+                buffer[length++] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+                buffer[length++] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                buffer[length++] = static_cast<char>(0x80 | (cp & 0x3F));
+            }
+        }
+        assign({ buffer, length });
+    }
+
+    void clear()
+    {
+        mSize = 0;
+        mOverflow.clear();
+    }
+
+    std::string_view view() const
+    {
+        if (mSize == OVERFLOW_SIZE) {
+            return mOverflow;
+        }
+        return { mInline, mSize };
+    }
+
+    operator std::string_view() const { return view(); }
+
+    const char *data() const { return view().data(); }
+    size_t size() const { return view().size(); }
+    bool empty() const { return mSize == 0; }
+
+    /// Stored without allocating
+    bool isInline() const { return mSize != OVERFLOW_SIZE; }
+
+    bool operator==(const KeyText &other) const { return view() == other.view(); }
+
+private:
+    static constexpr uint8_t OVERFLOW_SIZE = 0xFF;
+
+    uint8_t mSize { 0 };
+    char mInline[INLINE_CAPACITY] {};
+    std::string mOverflow;  // Only used when mSize == OVERFLOW_SIZE
+};
+
+} // namespace konflikt
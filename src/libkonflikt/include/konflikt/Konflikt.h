@@ -1,13 +1,28 @@
 #pragma once
 
+#include "Backoff.h"
+#include "InstanceRegistry.h"
+#include "KeyRemap.h"
+#include "LinkQuality.h"
 #include "Platform.h"
+#include "PointerMotion.h"
+#include "PressedState.h"
 #include "Protocol.h"
 #include "Rect.h"
-
+#include "ServerCache.h"
+#include "Snapshot.h"
+#include "ThreadUtil.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -16,8 +31,11 @@ namespace konflikt {
 // Forward declarations
 class WebSocketServer;
 class WebSocketClient;
+class ConfigWatcher;
 class HttpServer;
+class InputTraceWriter;
 class LayoutManager;
+class NetworkMonitor;
 class ServiceDiscovery;
 struct DiscoveredService;
 
@@ -37,6 +55,7 @@ struct Config
 
     // Server settings
     int port { 3000 };
+    int maxClients { 0 };    // Refuse new clients beyond this many (0 = no limit)
 
     // Client settings
     std::string serverHost;
@@ -63,6 +82,8 @@ struct Config
         bool right { true };
         bool top { true };
         bool bottom { true };
+
+        bool operator==(const DisplayEdges &) const = default;
     };
     std::unordered_map<uint32_t, DisplayEdges> displayEdges;
 
@@ -90,7 +111,9 @@ struct Config
     bool enableDebugApi { false };
 
     // Key remapping: map of source keycode -> target keycode
-    // Applied when sending input events to clients
+    // Applied when sending input events to clients. Keys are also sent as USB HID
+    // usages that clients translate to their own keycodes, so this is only needed
+    // for deliberate remaps; a remapped key is sent by keycode alone.
     // Example: {"55": 133} maps Mac Command Left (55) to Linux Super Left (133)
     // Common mappings:
     //   Mac Command Left (55) <-> Linux Super Left (133)
@@ -101,6 +124,30 @@ struct Config
 
     // Log keycodes for debugging key remapping (shows pressed keycodes in log)
     bool logKeycodes { false };
+
+    // Input tracing (server only, not persisted)
+    std::string traceRecordFile;     // Record captured platform events to this file
+    std::string traceReplayFile;     // Replay a recorded trace through the event pipeline
+    double traceReplaySpeed { 1.0 }; // Replay speed multiplier (0 = as fast as possible)
+
+    // Pointer acceleration for remote screens (server), see PointerCurve
+    double pointerSpeed { 1.0 };
+    double pointerAcceleration { 0.0 };             // 0 = constant gain
+    double pointerAccelerationThreshold { 0.5 };    // Velocity (counts/ms) where acceleration starts
+
+    // Client: smooth bursty mouse motion, adding at most this much latency (0 = off)
+    double jitterBufferMs { 0.0 };
+
+    // Scheduling for the input capture thread, the network thread (HTTP and
+    // WebSocket server loop) and the client connection thread. Names are set
+    // by Konflikt; see ThreadOptions.
+    ThreadOptions captureThread;
+    ThreadOptions networkThread;
+    ThreadOptions clientThread;
+
+    // File the config was loaded from (not persisted); watched for changes,
+    // which are applied without a restart where possible
+    std::string configPath;
 };
 
 /// Connection status
@@ -179,6 +226,11 @@ public:
     /// Get the HTTP server port (may differ from config if auto-assigned)
     int httpPort() const;
 
+    /// Post a recorded input trace to the main loop's platform event handler
+    /// (blocks until fed or stopped); speed scales the original timing, 0
+    /// replays as fast as possible
+    bool replayTrace(const std::string &path, double speed);
+
     /// Get the number of connected clients (server only)
     size_t clientCount() const { return mConnectedClients.size(); }
 
@@ -188,21 +240,57 @@ public:
 private:
     // Event handlers
     void onPlatformEvent(const Event &event);
-    void onWebSocketMessage(const std::string &message, void *connection);
+    void onWebSocketMessage(std::string_view message, void *connection);
     void onClientConnected(void *connection);
     void onClientDisconnected(void *connection);
+    void onDesktopChanged();
 
     // Message handlers
     void handleHandshakeRequest(const HandshakeRequest &request, void *connection);
     void handleHandshakeResponse(const HandshakeResponse &response);
     void handleInputEvent(const InputEventMessage &message);
+    void injectMouseMove(const Event &event);
     void handleClientRegistration(const ClientRegistrationMessage &message);
+    void handleScreenGeometryUpdate(const ScreenGeometryUpdateMessage &message);
+    void sendScreenGeometry();
     void handleLayoutAssignment(const LayoutAssignmentMessage &message);
     void handleLayoutUpdate(const LayoutUpdateMessage &message);
     void handleActivateClient(const ActivateClientMessage &message);
     void handleDeactivationRequest(const DeactivationRequestMessage &message);
     void handleClipboardSync(const ClipboardSyncMessage &message);
     void handleServerShutdown(const ServerShutdownMessage &message);
+    void handleHeartbeat(const HeartbeatMessage &message, void *connection);
+    void handleStateReset(const StateResetMessage &message);
+
+    // Held input tracking
+    void sendHeartbeat();
+    void sendStateReset(InstanceHandle client);
+    void releaseInjectedInput();  // Session teardown: releases everything, drops queued motion
+    void reconcileInjectedInput(const PressedState &keep);  // Releases what is not in keep
+
+    // Input coalescing
+    void queueScroll(const Event &event);
+    void queueMotion(const InputEventData &data);
+    void flushPendingInput(bool force = false);
+
+    // Link health
+    void checkLinks();
+    void checkClientLinks();  // Server half of checkLinks(), on the network thread
+
+    // Session resumption (server)
+    void expireSessions();
+    void endSession(InstanceHandle handle);  // Drops the client, its screen and its handle
+    static std::string generateSessionToken();
+
+    // Reconnection
+    void checkReconnect();
+    void resetReconnect();
+    void rememberServer(const std::string &host, int port, double rttMs);
+    void saveServerCache();
+
+    // Config file reload
+    void checkConfigFile();
+    void applyConfigChanges(const Config &before, const Config &after);
 
     // Clipboard
     void checkClipboardChange();
@@ -212,23 +300,39 @@ private:
     void onServiceFound(const DiscoveredService &service);
     void onServiceLost(const std::string &name);
     void connectToDiscoveredServer(const std::string &host, int port);
+    ServiceInfo serviceInfo() const;
+    std::string incompatibility(const ServiceInfo &info) const;  // Empty if the server is usable
 
     // Screen transition
     bool checkScreenTransition(int32_t x, int32_t y);
-    void activateClient(const std::string &targetInstanceId, int32_t cursorX, int32_t cursorY);
+    void activateClient(InstanceHandle target, int32_t cursorX, int32_t cursorY);
     void deactivateRemoteScreen();
     void requestDeactivation();
 
     // Broadcasting
-    void broadcastInputEvent(const std::string &eventType, const InputEventData &data);
-    void broadcastToClients(const std::string &message);
+    void broadcastInputEvent(std::string_view eventType, const InputEventData &data);
+    void broadcastToClients(std::string_view message);
+    void broadcastLayoutUpdate();
+    std::vector<ScreenInfo> layoutScreens() const;
+
+    // Main loop task queue
+    void post(std::function<void()> task);
+    void runTasks();
+
+    // Startup
+    void initServiceDiscovery();
+    void timeStartupStep(const std::string &name, const std::function<void()> &step);
+    void logStartupTimeline();
 
     // Utility
     void updateStatus(ConnectionStatus status, const std::string &message);
     void log(const std::string &level, const std::string &message);
     std::string generateMachineId();
     std::string generateDisplayId();
-    uint32_t remapKeycode(uint32_t keycode) const;
+    uint32_t remapKeycode(uint32_t keycode) const { return mKeyRemap.read().remap(keycode); }
+    void rebuildKeyRemap();
+    void rebuildEdges();
+    void rebuildPointerCurve();
     Config::DisplayEdges getEdgeSettingsForPoint(int32_t x, int32_t y) const;
 
     // Configuration
@@ -238,39 +342,81 @@ private:
     std::unique_ptr<IPlatform> mPlatform;
     Logger mLogger;
 
+    // Input tracing
+    std::unique_ptr<InputTraceWriter> mTraceWriter;
+    std::thread mReplayThread;
+    std::mutex mReplayMutex;
+    std::condition_variable mReplayCondition;  // Signalled by stop() to end a wait between records
+
+    // Pointer motion (declared before networking so it outlives the client thread)
+    PointerAccelerator mPointerAccelerator;          // Server: listener thread only
+    Snapshot<PointerCurve> mPointerCurve;            // Config pointer settings, read by the listener thread
+    std::unique_ptr<MotionJitterBuffer> mJitterBuffer;  // Client: null when disabled
+    std::mutex mInjectMutex;  // Client: the jitter buffer injects from its own thread; taken after its locks
+
+    // Tasks for the main loop, posted by other threads (e.g. service discovery
+    // events) instead of touching main loop state. Declared before networking
+    // so it outlives the threads that post.
+    std::mutex mTasksMutex;
+    std::condition_variable mTasksCondition;
+    std::vector<std::function<void()>> mTasks;
+
     // Networking
     std::unique_ptr<WebSocketServer> mWsServer;
     std::unique_ptr<WebSocketClient> mWsClient;
     std::unique_ptr<HttpServer> mHttpServer;
     std::unique_ptr<ServiceDiscovery> mServiceDiscovery;
+    int mAdvertisedClients { -1 };  // Main thread: client count in the published TXT record
 
     // Layout
     std::unique_ptr<LayoutManager> mLayoutManager;
 
+    // Startup timeline, relative to the start of init(). Steps run on several
+    // threads, so they are recorded under mStartupMutex.
+    struct StartupStep
+    {
+        std::string name;
+        double startMs { 0 };
+        double durationMs { 0 };
+    };
+    std::chrono::steady_clock::time_point mStartupBegin;
+    mutable std::mutex mStartupMutex;
+    std::vector<StartupStep> mStartupSteps;
+    double mStartupReadyMs { 0 };  // Main loop running, 0 while starting
+
     // State
-    bool mRunning { false };
-    uint64_t mStartTime { 0 };
-    ConnectionStatus mConnectionStatus { ConnectionStatus::Disconnected };
+    std::atomic<bool> mRunning { false };
+    uint64_t mStartTime { 0 };  // monotonicNs()
+    std::atomic<ConnectionStatus> mConnectionStatus { ConnectionStatus::Disconnected };  // Set by the client thread too
     std::string mConnectedServerName;
     bool mIsActiveInstance { false };
-    Rect mScreenBounds;
 
-    // Virtual cursor for remote screen control
-    struct
+    // Screen geometry and the virtual cursor. The capture, listener, network
+    // and client threads all touch these, so they are guarded by mCursorMutex.
+    struct VirtualCursor
     {
         int32_t x {};
         int32_t y {};
-    } mVirtualCursor;
-
-    bool mHasVirtualCursor { false };
+    };
+    Rect mScreenBounds;
+    VirtualCursor mVirtualCursor;  // Virtual cursor for remote screen control
     Rect mActiveRemoteScreenBounds;
+    mutable std::mutex mCursorMutex;
+    Rect screenBounds() const;
+    VirtualCursor virtualCursor() const;
+
+    std::atomic<bool> mHasVirtualCursor { false };  // Also read by the main loop to flush coalesced input
 
     // Client tracking
-    std::string mActivatedClientId;
+    InstanceRegistry mInstances;
+    InstanceHandle mOwnHandle { NO_INSTANCE };     // Ours; on a client, as assigned by the server
+    InstanceHandle mServerHandle { NO_INSTANCE };  // Client: source of the server's input events
+    std::atomic<InstanceHandle> mActivatedClient { NO_INSTANCE };  // Set by the capture thread, read by the network thread
     std::string mMachineId;
     std::string mDisplayId;
-    uint64_t mLastDeactivationTime { 0 };
-    uint64_t mLastDeactivationRequest { 0 };
+    uint64_t mLastDeactivationTime { 0 };     // monotonicNs()
+    uint64_t mLastDeactivationRequest { 0 };  // monotonicNs(), main loop
+    std::atomic<bool> mDeactivationPosted { false };  // Client: a requestDeactivation() is queued
 
     // Client connection tracking (for server)
     struct ConnectedClient
@@ -281,22 +427,90 @@ private:
         int32_t screenHeight {};
         uint64_t connectedAt {};
         bool active { false };  // Currently receiving input
+        std::string sessionToken;
+        uint64_t disconnectedAt { 0 };  // monotonicNs(); non-zero while the session waits to be resumed
+    };
+    // Network thread only
+    std::unordered_map<void *, InstanceHandle> mConnectionToInstance;
+    InstanceTable<ConnectedClient> mConnectedClients;
+
+    // Session resumption: a client that reconnects within the grace period with
+    // its session token keeps its layout slot and skips registration. If it was
+    // active it stays active for SESSION_ACTIVE_HOLD_MS of that.
+    static constexpr uint64_t SESSION_GRACE_MS = 10000;
+    static constexpr uint64_t SESSION_ACTIVE_HOLD_MS = 3000;
+    std::string mSessionToken;  // Client: token from the last handshake
+    InputEventMessage mReceivedInput;  // Client thread: reused for every input_event
+
+    // Compiled key remap table, republished when Config::keyRemap changes.
+    // Read by the capture thread only.
+    Snapshot<KeyRemapTable> mKeyRemap;
+
+    // Edge settings for the capture thread, published the same way whenever the
+    // global or per-display edges change
+    struct EdgeTable
+    {
+        Config::DisplayEdges global;
+        std::unordered_map<uint32_t, Config::DisplayEdges> displays;
     };
-    std::unordered_map<void *, std::string> mConnectionToInstanceId;
-    std::unordered_map<std::string, ConnectedClient> mConnectedClients;
+    Snapshot<EdgeTable> mEdges;
+    std::atomic<uint32_t> mLockCursorHotkey { 0 };  // Capture thread copy of Config::lockCursorHotkey
+
+    // Config file watching (main thread). Changes are applied on the network
+    // thread, where the config API makes its changes too.
+    std::unique_ptr<ConfigWatcher> mConfigWatcher;
+    Config mFileConfig;                 // The file as last read, to tell what an edit changed
+    uint64_t mConfigReloadAt { 0 };     // Pending reload (monotonicNs()), 0 = none
+    static constexpr uint64_t CONFIG_RELOAD_DELAY_MS = 200;  // Let editors finish writing
+
+    // Held input tracking (prevents stuck keys when a session ends mid-keystroke)
+    PressedState mForwardedState;  // Server: presses sent to the active client
+    PressedState mInjectedState;   // Client: presses injected locally, by wire keycode
+    std::array<uint32_t, PressedState::MAX_KEYCODE> mInjectedKeycodes {};  // Client: wire -> injected keycode
+    std::mutex mPressedStateMutex;
+    // Server: held from recording a press to sending it, and from a heartbeat's
+    // snapshot to sending it, so clients never get a snapshot older than a press
+    // that arrived before it. Taken before the locks the sends take.
+    std::mutex mForwardMutex;
+    uint64_t mLastHeartbeat { 0 };  // monotonicNs()
+    uint64_t mHeartbeatSeq { 0 };
+    static constexpr uint64_t HEARTBEAT_INTERVAL_MS = 250;
+
+    // Link health per client connection (server), fed by heartbeat echoes
+    std::unordered_map<void *, LinkQuality> mLinks;
+    std::mutex mLinksMutex;
+    LinkQuality::Clock::time_point mLastServerMessage {};  // Client: detects a dead server
+    bool mServerSendsHeartbeats { false };  // Client: else silence is not a dead server
+
+    // Input coalesced per network tick (server). Scroll always is, except for the
+    // first event of a burst; motion only while the active client's link is degraded.
+    std::mutex mPendingInputMutex;
+    InputEventData mPendingScroll;
+    bool mHasPendingScroll { false };
+    uint64_t mLastScrollSent { 0 };  // monotonicNs()
+    InputEventData mPendingMotion;
+    bool mHasPendingMotion { false };
+    std::atomic<bool> mCoalesceMotion { false };
+    static constexpr uint64_t SCROLL_FLUSH_INTERVAL_MS = 10;
 
     // Clipboard sync
     std::string mLastClipboardText;
     uint32_t mClipboardSequence { 0 };
-    uint64_t mLastClipboardCheck { 0 };
+    uint64_t mLastClipboardCheck { 0 };  // monotonicNs()
 
-    // Reconnection
-    uint64_t mLastReconnectAttempt { 0 };
-    int mReconnectAttempts { 0 };
+    // Reconnection (client), retried without limit while mAutoReconnect is set
+    mutable std::mutex mReconnectMutex;
+    Backoff mReconnectBackoff;           // Guarded by mReconnectMutex
+    uint64_t mNextReconnectAt { 0 };     // monotonicNs(), guarded by mReconnectMutex; 0 = not scheduled yet
+    std::atomic<bool> mAutoReconnect { true };  // Cleared by /api/disconnect
     bool mExpectingReconnect { false };  // Set when server sent graceful shutdown
     int32_t mExpectedRestartDelayMs { 0 };
-    static constexpr int MAX_RECONNECT_ATTEMPTS = 10;
-    static constexpr uint64_t RECONNECT_DELAY_MS = 3000;
+    std::unique_ptr<NetworkMonitor> mNetworkMonitor;
+
+    // Known servers (client without a configured serverHost)
+    mutable std::mutex mServerCacheMutex;
+    ServerCache mServerCache;            // Guarded by mServerCacheMutex
+    LinkQuality::Clock::time_point mHandshakeSentAt {};  // Client thread: measures handshake RTT
 
     // Callbacks
     StatusCallback mStatusCallback;
@@ -320,7 +534,7 @@ private:
         uint64_t mouseEvents { 0 };
         uint64_t keyEvents { 0 };
         uint64_t scrollEvents { 0 };
-        uint64_t windowStartTime { 0 };
+        uint64_t windowStartTime { 0 };  // monotonicNs()
         uint64_t eventsInWindow { 0 };
         double eventsPerSecond { 0.0 };
         // Latency tracking (client-side only, measures event timestamp to execution)
@@ -330,8 +544,12 @@ private:
         uint64_t latencySamples { 0 };
         double latencySum { 0.0 };
     };
-    InputStats mInputStats;
-    void updateInputStats(const std::string &eventType);
+    InputStats mInputStats;  // Guarded by mInputStatsMutex: updated by the capture, main and client threads
+    std::mutex mInputStatsMutex;
+
+    // Thread scheduler statistics at the last stats reset, by thread name
+    std::unordered_map<std::string, ThreadSchedStats> mThreadStatsBaseline;
+    void updateInputStats(std::string_view eventType);
     void recordLatency(uint64_t eventTimestamp);
 };
 
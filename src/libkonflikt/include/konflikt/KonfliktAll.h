@@ -2,14 +2,28 @@
 
 // Main Konflikt library header - includes all public headers
 
+#include "Backoff.h"
 #include "ConfigManager.h"
+#include "ConfigWatcher.h"
 #include "HttpServer.h"
+#include "InputTrace.h"
+#include "InstanceRegistry.h"
+#include "KeyCodes.h"
+#include "KeyRemap.h"
+#include "KeyText.h"
 #include "Konflikt.h"
 #include "LayoutManager.h"
+#include "LinkQuality.h"
+#include "NetworkMonitor.h"
 #include "Platform.h"
+#include "PointerMotion.h"
+#include "PressedState.h"
 #include "Protocol.h"
 #include "Rect.h"
+#include "ServerCache.h"
 #include "ServiceDiscovery.h"
+#include "Snapshot.h"
+#include "ThreadUtil.h"
 #include "WebSocketClient.h"
 #include "WebSocketServer.h"
 
@@ -1,12 +1,12 @@
 #pragma once
 
+#include "InstanceRegistry.h"
 #include "Protocol.h"
 #include "Rect.h"
 
 #include <functional>
 #include <optional>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 namespace konflikt {
@@ -14,6 +14,7 @@ namespace konflikt {
 /// Screen entry in the layout
 struct ScreenEntry
 {
+    InstanceHandle handle { NO_INSTANCE };
     std::string instanceId;
     std::string displayName;
     std::string machineId;
@@ -43,42 +44,49 @@ enum class Side
 };
 
 /// Layout manager for managing screen arrangements
+///
+/// Screens are keyed by instance handle; IDs are looked up in the registry
+/// only to fill in ScreenEntry::instanceId and Adjacency for the wire.
 class LayoutManager
 {
 public:
-    LayoutManager();
+    explicit LayoutManager(const InstanceRegistry &instances);
     ~LayoutManager();
 
     /// Set the server's own screen
-    void setServerScreen(const std::string &instanceId,
+    void setServerScreen(InstanceHandle handle,
                          const std::string &displayName,
                          const std::string &machineId,
                          int32_t width, int32_t height);
 
     /// Register a client screen
-    ScreenEntry registerClient(const std::string &instanceId,
+    ScreenEntry registerClient(InstanceHandle handle,
                                const std::string &displayName,
                                const std::string &machineId,
                                int32_t width, int32_t height);
 
+    /// Resize a screen after its displays changed; neighbours are shifted to
+    /// stay adjacent. Returns false if the screen is unknown or unchanged
+    bool updateScreenSize(InstanceHandle handle, int32_t width, int32_t height);
+
     /// Unregister a client
-    void unregisterClient(const std::string &instanceId);
+    void unregisterClient(InstanceHandle handle);
 
     /// Set client online/offline status
-    void setClientOnline(const std::string &instanceId, bool online);
+    void setClientOnline(InstanceHandle handle, bool online);
 
     /// Get the full layout
     std::vector<ScreenEntry> getLayout() const;
 
     /// Get a specific screen
-    std::optional<ScreenEntry> getScreen(const std::string &instanceId) const;
+    std::optional<ScreenEntry> getScreen(InstanceHandle handle) const;
 
     /// Get adjacency for a screen
-    Adjacency getAdjacencyFor(const std::string &instanceId) const;
+    Adjacency getAdjacencyFor(InstanceHandle handle) const;
 
     /// Get transition target at an edge
     std::optional<TransitionTarget> getTransitionTargetAtEdge(
-        const std::string &fromInstanceId,
+        InstanceHandle from,
         Side edge,
         int32_t x, int32_t y) const;
 
@@ -86,11 +94,13 @@ public:
     std::function<void(const std::vector<ScreenEntry> &)> onLayoutChanged;
 
 private:
+    InstanceHandle neighbour(const ScreenEntry &screen, Side side) const;
     void notifyLayoutChanged();
     void arrangeScreens();
 
-    std::unordered_map<std::string, ScreenEntry> mScreens;
-    std::string mServerInstanceId;
+    const InstanceRegistry &mInstances;
+    InstanceTable<ScreenEntry> mScreens;
+    InstanceHandle mServerHandle { NO_INSTANCE };
 };
 
 } // namespace konflikt
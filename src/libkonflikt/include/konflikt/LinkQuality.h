@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace konflikt {
+
+/// Health of one connection, measured from heartbeat round trips
+///
+/// RTT is smoothed as in RFC 6298 and jitter as in RFC 3550. Since the
+/// transport is TCP nothing is lost outright; a heartbeat that isn't echoed
+/// within DEAD_TIMEOUT counts as lost, and silence longer than STALL_THRESHOLD
+/// counts as a stall. Silence only means something once the peer is known to
+/// echo heartbeats; until then the link is neither dead nor degraded.
+class LinkQuality
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Peer is considered dead after this long without any message
+    static constexpr auto DEAD_TIMEOUT = std::chrono::milliseconds(1000);
+
+    /// Silence longer than this is a stall (two missed heartbeats at 250 ms)
+    static constexpr auto STALL_THRESHOLD = std::chrono::milliseconds(500);
+
+    /// A link stays degraded this long after its last stall
+    static constexpr auto DEGRADED_HOLD = std::chrono::seconds(5);
+
+    static constexpr double DEGRADED_RTT_MS = 30.0;
+    static constexpr double DEGRADED_JITTER_MS = 8.0;
+
+    explicit LinkQuality(Clock::time_point now = Clock::now());
+
+    void heartbeatSent(uint64_t seq, Clock::time_point now);
+    void heartbeatAcked(uint64_t seq, Clock::time_point now);
+
+    /// Record any message from the peer
+    void received(Clock::time_point now);
+
+    /// Peer advertised heartbeat support at handshake
+    void setEchoesHeartbeats(bool echoes) { mEchoesHeartbeats = echoes; }
+    bool echoesHeartbeats() const { return mEchoesHeartbeats; }
+
+    bool isDead(Clock::time_point now) const { return mEchoesHeartbeats && now - mLastReceived > DEAD_TIMEOUT; }
+    bool isDegraded(Clock::time_point now) const;
+
+    double rttMs() const { return mRttMs; }
+    double lastRttMs() const { return mLastRttMs; }
+    double jitterMs() const { return mJitterMs; }
+    uint64_t heartbeatsSent() const { return mSent; }
+    uint64_t heartbeatsAcked() const { return mAcked; }
+    uint64_t heartbeatsLost() const { return mLost; }
+    uint64_t stalls() const { return mStalls; }
+    double maxStallMs() const { return mMaxStallMs; }
+    double silenceMs(Clock::time_point now) const { return toMs(now - mLastReceived); }
+
+private:
+    static double toMs(Clock::duration duration) { return std::chrono::duration<double, std::milli>(duration).count(); }
+
+    struct Pending
+    {
+        uint64_t seq {};
+        Clock::time_point sent {};
+        bool active { false };
+    };
+
+    void expire(Clock::time_point now);
+
+    std::array<Pending, 8> mPending {};
+    Clock::time_point mLastReceived;
+    Clock::time_point mLastStall {};
+    bool mHasStalled { false };
+    bool mEchoesHeartbeats { false };
+    bool mHasRtt { false };
+
+    double mRttMs { 0.0 };
+    double mLastRttMs { 0.0 };
+    double mJitterMs { 0.0 };
+    uint64_t mSent { 0 };
+    uint64_t mAcked { 0 };
+    uint64_t mLost { 0 };
+    uint64_t mStalls { 0 };
+    double mMaxStallMs { 0.0 };
+};
+
+} // namespace konflikt
@@ -0,0 +1,33 @@
+#pragma once
+
+namespace konflikt {
+
+/// Watches for network configuration changes (links, addresses, routes)
+///
+/// Linux listens on an rtnetlink socket, macOS registers for the system
+/// configuration's network change notification. Both are polled, so the
+/// monitor needs no thread of its own.
+class NetworkMonitor
+{
+public:
+    NetworkMonitor() = default;
+    ~NetworkMonitor();
+
+    // Non-copyable
+    NetworkMonitor(const NetworkMonitor &) = delete;
+    NetworkMonitor &operator=(const NetworkMonitor &) = delete;
+
+    /// Start watching; returns false if changes can't be observed here
+    bool start();
+
+    /// Stop watching
+    void stop();
+
+    /// Check whether the network changed since the last call (non-blocking)
+    bool poll();
+
+private:
+    int mHandle { -1 };  // Netlink socket on Linux, notify token on macOS
+};
+
+} // namespace konflikt
@@ -1,5 +1,9 @@
 #pragma once
 
+#include "KeyText.h"
+#include "ThreadUtil.h"
+
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <functional>
@@ -45,8 +49,8 @@ struct InputState
     int32_t y {};
     int32_t dx {};
     int32_t dy {};
-    double scrollX {};  // Horizontal scroll delta
-    double scrollY {};  // Vertical scroll delta
+    double scrollX {};  // Horizontal scroll in wheel clicks, positive right (fractional for smooth scrolling)
+    double scrollY {};  // Vertical scroll in wheel clicks, positive up
     uint32_t keyboardModifiers {};
     uint32_t mouseButtons {};
 };
@@ -60,6 +64,8 @@ struct Display
     int32_t width {};
     int32_t height {};
     bool isPrimary { false };
+
+    bool operator==(const Display &) const = default;
 };
 
 /// Desktop (virtual screen) information
@@ -68,6 +74,8 @@ struct Desktop
     int32_t width {};
     int32_t height {};
     std::vector<Display> displays;
+
+    bool operator==(const Desktop &) const = default;
 };
 
 /// Event types
@@ -90,7 +98,8 @@ struct Event
     InputState state;
     MouseButton button { MouseButton::None };
     uint32_t keycode {};
-    std::string text;
+    uint16_t hidUsage {};  // USB HID usage (keyboard page), 0 if unknown
+    KeyText text;          // UTF-8, inline for single characters
 };
 
 /// Clipboard selection type
@@ -140,6 +149,13 @@ public:
     /// Stop listening for input events
     virtual void stopListening() = 0;
 
+    /// Report DesktopChanged without capturing input (clients); stopped by
+    /// stopListening(), superseded by startListening()
+    virtual void startWatchingDesktop() = 0;
+
+    /// Scheduling options for the input listener thread, applied when it starts
+    virtual void setListenerThreadOptions(const ThreadOptions &options) = 0;
+
     /// Show the cursor
     virtual void showCursor() = 0;
 
@@ -173,7 +189,10 @@ inline uint32_t toUInt32(KeyboardModifier modifier)
     return static_cast<uint32_t>(modifier);
 }
 
-/// Get current timestamp in milliseconds
+/// Get current wall-clock timestamp in milliseconds since the epoch
+///
+/// For anything shown to users or sent to other machines. Use monotonicNs()
+/// to measure intervals: wall-clock time jumps when NTP or the user sets it.
 inline uint64_t timestamp()
 {
     return static_cast<uint64_t>(
@@ -182,4 +201,21 @@ inline uint64_t timestamp()
             .count());
 }
 
+/// Nanoseconds per millisecond, for comparing monotonicNs() against ms settings
+constexpr uint64_t NS_PER_MS = 1000000;
+
+/// Get monotonic time in nanoseconds, for cooldowns, deadlines and rates
+///
+/// Never goes backwards. The epoch is arbitrary and differs between machines,
+/// and may be the current instant, so the result is clamped to at least 1 to
+/// keep 0 free to mean "not set".
+inline uint64_t monotonicNs()
+{
+    uint64_t now = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+    return std::max<uint64_t>(now, 1);
+}
+
 } // namespace konflikt
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "Platform.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace konflikt {
+
+/// Acceleration curve for relative pointer motion
+///
+/// gain = speed * (1 + acceleration * max(0, velocity - threshold)), with
+/// velocity in device counts per millisecond. acceleration = 0 is a flat curve.
+struct PointerCurve
+{
+    double speed { 1.0 };
+    double acceleration { 0.0 };
+    double threshold { 0.5 };
+};
+
+/// Applies a PointerCurve to raw motion deltas
+///
+/// Sub-pixel results are carried over so slow movements aren't rounded away.
+class PointerAccelerator
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Largest gain applied, as a multiple of the curve's base speed
+    static constexpr double MAX_GAIN = 8.0;
+
+    /// Scale a delta received at the given time
+    void apply(const PointerCurve &curve, int32_t &dx, int32_t &dy, Clock::time_point now = Clock::now());
+
+    /// Forget velocity and remainders (e.g. when the cursor changes screens)
+    void reset();
+
+    /// Smoothed pointer velocity in counts per millisecond
+    double velocity() const { return mVelocity; }
+
+private:
+    Clock::time_point mLastMotion {};
+    double mVelocity { 0.0 };
+    double mRemainderX { 0.0 };
+    double mRemainderY { 0.0 };
+};
+
+/// Client-side playout buffer for mouse motion
+///
+/// Motion arriving in bursts is released at the pace it was sent, using the
+/// sender's monotonic send times. A sample is never held longer than the
+/// target delay, so the buffer bounds the latency it adds.
+class MotionJitterBuffer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    /// Injects one motion event, on the pushing thread or the buffer's own.
+    /// Calls never overlap and run outside the queue lock, but must not call
+    /// back into the buffer.
+    using Playout = std::function<void(const Event &event)>;
+
+    MotionJitterBuffer(std::chrono::microseconds target, Playout playout);
+    ~MotionJitterBuffer();
+
+    MotionJitterBuffer(const MotionJitterBuffer &) = delete;
+    MotionJitterBuffer &operator=(const MotionJitterBuffer &) = delete;
+
+    /// Queue a motion event sent at sentNs (the sender's monotonicNs()); with
+    /// 0, falls back to event.timestamp, the sender's wall clock in ms
+    void push(const Event &event, uint64_t sentNs);
+
+    /// Play queued motion now, before injecting an event that must follow it
+    void flush();
+
+    /// Drop queued motion and restart delay estimation
+    void clear();
+
+    std::chrono::microseconds target() const { return mTarget; }
+
+    /// Samples played after being held in the buffer
+    uint64_t delayedSamples() const { return mDelayedSamples; }
+
+private:
+    struct Sample
+    {
+        Clock::time_point due;
+        Event event;
+    };
+
+    void run();
+    void playDue(Clock::time_point now);
+
+    const std::chrono::microseconds mTarget;
+    const Playout mPlayout;
+
+    // Held across taking samples off the queue and playing them, so playout
+    // stays in order without holding mMutex. Taken before mMutex.
+    std::mutex mPlayoutMutex;
+    std::vector<Event> mBatch;  // Guarded by mPlayoutMutex
+
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::deque<Sample> mQueue;
+    bool mStopping { false };
+
+    // Smallest (arrival - send) seen, i.e. the transit time of an undelayed packet.
+    // Re-estimated every window so clock drift doesn't accumulate.
+    bool mHasOffset { false };
+    int64_t mOffsetUs { 0 };
+    int64_t mWindowOffsetUs { 0 };
+    Clock::time_point mWindowStart {};
+
+    std::atomic<uint64_t> mDelayedSamples { 0 };
+
+    std::thread mThread;  // Last, so it starts after the members it uses
+};
+
+} // namespace konflikt
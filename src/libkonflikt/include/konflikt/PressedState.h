@@ -0,0 +1,97 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace konflikt {
+
+/// Compact set of held keys and mouse buttons
+///
+/// Used on both ends of a connection to know which keyReleases are still
+/// owed, so they can be synthesized when a session ends mid-keystroke.
+class PressedState
+{
+public:
+    /// Keycodes at or above this are not tracked
+    static constexpr uint32_t MAX_KEYCODE = 512;
+
+    void pressKey(uint32_t keycode)
+    {
+        if (keycode < MAX_KEYCODE)
+            mKeys[keycode / 64] |= bit(keycode);
+    }
+
+    void releaseKey(uint32_t keycode)
+    {
+        if (keycode < MAX_KEYCODE)
+            mKeys[keycode / 64] &= ~bit(keycode);
+    }
+
+    bool isKeyPressed(uint32_t keycode) const
+    {
+        return keycode < MAX_KEYCODE && (mKeys[keycode / 64] & bit(keycode)) != 0;
+    }
+
+    void pressButton(uint32_t button) { mButtons |= button; }
+    void releaseButton(uint32_t button) { mButtons &= ~button; }
+    bool isButtonPressed(uint32_t button) const { return (mButtons & button) != 0; }
+
+    /// Bitmask of held MouseButton flags
+    uint32_t buttons() const { return mButtons; }
+
+    /// Held keycodes in ascending order
+    std::vector<uint32_t> keys() const
+    {
+        std::vector<uint32_t> result;
+        for (uint32_t word = 0; word < WORDS; ++word) {
+            uint64_t bits = mKeys[word];
+            while (bits) {
+                result.push_back(word * 64 + static_cast<uint32_t>(std::countr_zero(bits)));
+                bits &= bits - 1;
+            }
+        }
+        return result;
+    }
+
+    bool empty() const
+    {
+        uint64_t any = mButtons;
+        for (uint64_t word : mKeys)
+            any |= word;
+        return any == 0;
+    }
+
+    void clear() { *this = PressedState(); }
+
+    /// Order-independent summary of the state; 0 when nothing is held
+    uint64_t digest() const
+    {
+        if (empty())
+            return 0;
+
+        // FNV-1a over the key words and button mask
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        auto mix = [&hash](uint64_t value) {
+            for (int i = 0; i < 8; ++i) {
+                hash ^= (value >> (i * 8)) & 0xFF;
+                hash *= 0x100000001b3ULL;
+            }
+        };
+        for (uint64_t word : mKeys)
+            mix(word);
+        mix(mButtons);
+        return hash;
+    }
+
+    bool operator==(const PressedState &other) const = default;
+
+private:
+    static constexpr uint32_t WORDS = MAX_KEYCODE / 64;
+    static constexpr uint64_t bit(uint32_t keycode) { return 1ULL << (keycode % 64); }
+
+    uint64_t mKeys[WORDS] {};
+    uint32_t mButtons {};
+};
+
+} // namespace konflikt
@@ -1,9 +1,13 @@
 #pragma once
 
+#include "InstanceRegistry.h"
+#include "KeyText.h"
+
 #include <cstdint>
 #include <glaze/json.hpp>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace konflikt {
@@ -18,14 +22,16 @@ struct InputEventData
     int32_t y {};
     int32_t dx {};
     int32_t dy {};
-    double scrollX {};  // Horizontal scroll delta
-    double scrollY {};  // Vertical scroll delta
+    double scrollX {};  // Horizontal scroll in wheel clicks, positive right (fractional for smooth scrolling)
+    double scrollY {};  // Vertical scroll in wheel clicks, positive up
     uint64_t timestamp {};
+    uint64_t sentNs {};    // Sender's monotonicNs() when sent; only differences mean anything, 0 if unknown
     uint32_t keyboardModifiers {};
     uint32_t mouseButtons {};
-    uint32_t keycode {};
+    uint32_t keycode {};   // Sender's platform keycode
+    uint32_t usage {};     // USB HID usage, preferred over keycode when non-zero
     std::string button;
-    std::string text;
+    KeyText text;          // UTF-8 text produced by the key, if any
 };
 
 // ============================================================================
@@ -87,6 +93,7 @@ struct HandshakeRequest
     std::vector<std::string> capabilities;
     std::optional<std::string> gitCommit;
     uint64_t timestamp {};
+    std::optional<std::string> resumeToken;  // Session token from the previous connection
 };
 
 /// Handshake response from server to client
@@ -100,15 +107,18 @@ struct HandshakeResponse
     std::vector<std::string> capabilities;
     std::optional<std::string> gitCommit;
     uint64_t timestamp {};
+    std::optional<std::string> sessionToken;  // Present to resume this session after a reconnect
+    std::optional<bool> resumed;              // Previous session resumed; no registration needed
+    std::optional<InstanceHandle> handle;        // The client's handle
+    std::optional<InstanceHandle> serverHandle;  // The server's handle, the source of its input events
 };
 
 /// Input event message (mouse/keyboard)
 struct InputEventMessage
 {
     std::string type = "input_event";
-    std::string sourceInstanceId;
-    std::string sourceDisplayId;
-    std::string sourceMachineId;
+    InstanceHandle source { NO_INSTANCE };       // Sender's handle from the handshake
+    std::optional<std::string> sourceInstanceId;  // Sent by servers that predate handles
     std::string eventType; // mouseMove, mousePress, mouseRelease, keyPress, keyRelease
     InputEventData eventData;
 };
@@ -124,6 +134,16 @@ struct ClientRegistrationMessage
     int32_t screenHeight {};
 };
 
+/// Client screen size changed (monitor plugged, resolution changed)
+struct ScreenGeometryUpdateMessage
+{
+    std::string type = "screen_geometry_update";
+    std::string instanceId;
+    int32_t screenWidth {};
+    int32_t screenHeight {};
+    uint64_t timestamp {};
+};
+
 /// Instance info message
 struct InstanceInfoMessage
 {
@@ -171,9 +191,28 @@ struct DeactivationRequestMessage
 };
 
 /// Heartbeat message
+/// Carries the sender's held keys/buttons so both ends can detect stuck input.
+/// Clients echo the server's seq, which the server uses to measure link health.
 struct HeartbeatMessage
 {
     std::string type = "heartbeat";
+    std::string instanceId;              // Sender
+    std::string activeInstanceId;        // Server only: client currently receiving input
+    uint64_t pressedDigest {};           // PressedState::digest() (0 = nothing held)
+    std::vector<uint32_t> pressedKeys;   // Held keycodes
+    uint32_t pressedButtons {};          // Held MouseButton flags
+    uint64_t seq {};                     // Server: heartbeat number; client: number being echoed
+    uint64_t echoTimestamp {};           // Client only: timestamp of the heartbeat being echoed
+    uint64_t timestamp {};
+};
+
+/// State reset message
+/// Sent by the server when a client stops receiving input; the client
+/// releases every key and button it still holds
+struct StateResetMessage
+{
+    std::string type = "state_reset";
+    std::string targetInstanceId;
     uint64_t timestamp {};
 };
 
@@ -218,6 +257,9 @@ template <>
 struct glz::meta<konflikt::InputEventData>
 {
     using T = konflikt::InputEventData;
+    // Key text is serialized as a plain JSON string
+    static constexpr auto readText = [](T &self, const std::string &text) { self.text.assign(text); };
+    static constexpr auto writeText = [](const T &self) { return self.text.view(); };
     static constexpr auto value = object(
         "x", &T::x,
         "y", &T::y,
@@ -226,11 +268,13 @@ struct glz::meta<konflikt::InputEventData>
         "scrollX", &T::scrollX,
         "scrollY", &T::scrollY,
         "timestamp", &T::timestamp,
+        "sentNs", &T::sentNs,
         "keyboardModifiers", &T::keyboardModifiers,
         "mouseButtons", &T::mouseButtons,
         "keycode", &T::keycode,
+        "usage", &T::usage,
         "button", &T::button,
-        "text", &T::text);
+        "text", glz::custom<readText, writeText>);
 };
 
 template <>
@@ -288,7 +332,8 @@ struct glz::meta<konflikt::HandshakeRequest>
         "version", &T::version,
         "capabilities", &T::capabilities,
         "gitCommit", &T::gitCommit,
-        "timestamp", &T::timestamp);
+        "timestamp", &T::timestamp,
+        "resumeToken", &T::resumeToken);
 };
 
 template <>
@@ -303,7 +348,11 @@ struct glz::meta<konflikt::HandshakeResponse>
         "version", &T::version,
         "capabilities", &T::capabilities,
         "gitCommit", &T::gitCommit,
-        "timestamp", &T::timestamp);
+        "timestamp", &T::timestamp,
+        "sessionToken", &T::sessionToken,
+        "resumed", &T::resumed,
+        "handle", &T::handle,
+        "serverHandle", &T::serverHandle);
 };
 
 template <>
@@ -312,9 +361,8 @@ struct glz::meta<konflikt::InputEventMessage>
     using T = konflikt::InputEventMessage;
     static constexpr auto value = object(
         "type", &T::type,
+        "source", &T::source,
         "sourceInstanceId", &T::sourceInstanceId,
-        "sourceDisplayId", &T::sourceDisplayId,
-        "sourceMachineId", &T::sourceMachineId,
         "eventType", &T::eventType,
         "eventData", &T::eventData);
 };
@@ -332,6 +380,18 @@ struct glz::meta<konflikt::ClientRegistrationMessage>
         "screenHeight", &T::screenHeight);
 };
 
+template <>
+struct glz::meta<konflikt::ScreenGeometryUpdateMessage>
+{
+    using T = konflikt::ScreenGeometryUpdateMessage;
+    static constexpr auto value = object(
+        "type", &T::type,
+        "instanceId", &T::instanceId,
+        "screenWidth", &T::screenWidth,
+        "screenHeight", &T::screenHeight,
+        "timestamp", &T::timestamp);
+};
+
 template <>
 struct glz::meta<konflikt::InstanceInfoMessage>
 {
@@ -394,6 +454,23 @@ struct glz::meta<konflikt::HeartbeatMessage>
     using T = konflikt::HeartbeatMessage;
     static constexpr auto value = object(
         "type", &T::type,
+        "instanceId", &T::instanceId,
+        "activeInstanceId", &T::activeInstanceId,
+        "pressedDigest", &T::pressedDigest,
+        "pressedKeys", &T::pressedKeys,
+        "pressedButtons", &T::pressedButtons,
+        "seq", &T::seq,
+        "echoTimestamp", &T::echoTimestamp,
+        "timestamp", &T::timestamp);
+};
+
+template <>
+struct glz::meta<konflikt::StateResetMessage>
+{
+    using T = konflikt::StateResetMessage;
+    static constexpr auto value = object(
+        "type", &T::type,
+        "targetInstanceId", &T::targetInstanceId,
         "timestamp", &T::timestamp);
 };
 
@@ -460,4 +537,46 @@ std::optional<T> fromJson(std::string_view json)
     return result;
 }
 
+/// Serialize into buffer, reusing its capacity
+template <typename T>
+bool toJson(const T &message, std::string &buffer)
+{
+    if (glz::write_json(message, buffer)) {
+        buffer.clear();
+        return false;
+    }
+    return true;
+}
+
+/// Parse into an existing message, reusing the capacity of its strings.
+/// Fields absent from json keep their previous values.
+template <typename T>
+bool fromJson(std::string_view json, T &result)
+{
+    return !glz::read_json(result, json);
+}
+
+/// Parse into a reused input event, first clearing what the previous event set
+bool fromJson(std::string_view json, InputEventMessage &result);
+
+/// Serializes outgoing input events without allocating
+///
+/// The message and the JSON buffer are kept between calls, so once they have
+/// grown to fit, encoding a mouse move touches no heap. Not thread safe; use
+/// one per sending thread.
+class InputEventEncoder
+{
+public:
+    /// Set the sender's handle carried by every event
+    void setSource(InstanceHandle source) { mMessage.source = source; }
+
+    /// Encode an event, stamping sentNs with the current monotonicNs(); the
+    /// result is valid until the next call
+    std::string_view encode(std::string_view eventType, const InputEventData &data);
+
+private:
+    InputEventMessage mMessage;
+    std::string mBuffer;
+};
+
 } // namespace konflikt
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "ServiceDiscovery.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace konflikt {
+
+/// A server a client can connect to
+struct ServerEndpoint
+{
+    std::string host;
+    int port { 0 };
+
+    bool operator==(const ServerEndpoint &) const = default;
+};
+
+/// What a client knows about a server it has discovered or connected to
+struct CachedServer
+{
+    std::string host;
+    int port { 0 };
+    std::string name;
+    std::string instanceId;
+    uint64_t lastSeen { 0 };       // Discovered or connected (ms since epoch)
+    uint64_t lastConnected { 0 };  // Last accepted handshake (ms since epoch), 0 = never
+    double rttMs { -1.0 };         // Smoothed handshake round trip, -1 = not measured
+    int failures { 0 };            // Failed connects or lost connections since the last success
+
+    ServerEndpoint endpoint() const { return { host, port }; }
+};
+
+/// Discovered servers ranked for connecting, persisted across runs
+///
+/// A client connects to the best entry at startup without waiting for mDNS
+/// and moves down the list when a server fails. Ranking: fewest failures,
+/// then servers we have connected to before, then lowest RTT, then most
+/// recently seen. Not thread safe.
+class ServerCache
+{
+public:
+    /// Entries not seen for this long are dropped
+    static constexpr uint64_t MAX_AGE_MS = 30ull * 24 * 60 * 60 * 1000;
+    static constexpr size_t MAX_ENTRIES = 16;
+
+    /// Replace the entries, e.g. with what was loaded from disk
+    void assign(std::vector<CachedServer> servers, uint64_t now);
+
+    /// Record an mDNS announcement; returns true if the server is new
+    bool seen(const DiscoveredService &service, uint64_t now);
+
+    /// Record an accepted handshake and the round trip it took
+    void connected(const ServerEndpoint &server, double rttMs, uint64_t now);
+
+    /// Record a failed connect or a lost connection
+    void failed(const ServerEndpoint &server);
+
+    /// Best server to connect to, if any
+    std::optional<ServerEndpoint> best() const;
+
+    /// All entries, best first
+    std::vector<CachedServer> ranked() const;
+
+    const std::vector<CachedServer> &servers() const { return mServers; }
+
+private:
+    CachedServer &entry(const ServerEndpoint &server);
+    void prune(uint64_t now);
+
+    std::vector<CachedServer> mServers;
+};
+
+} // namespace konflikt
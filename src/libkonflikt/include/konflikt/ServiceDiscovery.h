@@ -2,11 +2,26 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 namespace konflikt {
 
+/// What a server publishes in its TXT record, so clients can skip servers
+/// they can't or shouldn't use without connecting first
+struct ServiceInfo
+{
+    std::string version;
+    std::string commit;                     // Empty if the build didn't know it
+    bool tls { false };
+    std::vector<std::string> capabilities;
+    int clients { 0 };                      // Connected clients
+    int maxClients { 0 };                   // 0 = no limit
+
+    bool isFull() const { return maxClients > 0 && clients >= maxClients; }
+};
+
 /// Information about a discovered service
 struct DiscoveredService
 {
@@ -14,9 +29,20 @@ struct DiscoveredService
     std::string host;
     int port;
     std::string instanceId;
+    std::optional<ServiceInfo> info;  // Missing if the server publishes only its id
 };
 
+/// TXT record entries ("key=value") for a service
+std::vector<std::string> serviceTxtEntries(const std::string &instanceId, const ServiceInfo &info);
+
+/// Parse one TXT record entry into a service; unknown keys are ignored
+void parseServiceTxtEntry(const std::string &key, const std::string &value, DiscoveredService &service);
+
 /// Callbacks for service discovery events
+///
+/// Called on the discovery thread (Avahi's threaded poll, or Bonjour's
+/// dispatch queue); hand the events over to the owning thread rather than
+/// touching its state from the callback.
 struct ServiceDiscoveryCallbacks
 {
     std::function<void(const DiscoveredService &service)> onServiceFound;
@@ -45,8 +71,14 @@ public:
     /// @param name Service display name
     /// @param port Port the service is running on
     /// @param instanceId Unique instance identifier
+    /// @param info Version, capabilities and load to publish in the TXT record
     /// @return true if registration started successfully
-    bool registerService(const std::string &name, int port, const std::string &instanceId);
+    bool registerService(const std::string &name, int port, const std::string &instanceId,
+                         const ServiceInfo &info = {});
+
+    /// Republish the TXT record of the registered service, e.g. when the
+    /// client count changes
+    void updateServiceInfo(const ServiceInfo &info);
 
     /// Unregister the service
     void unregisterService();
@@ -64,9 +96,6 @@ public:
     /// Check if service is registered
     bool isRegistered() const { return mRegistered; }
 
-    /// Process pending events (call periodically)
-    void poll();
-
     /// Get list of currently discovered services
     std::vector<DiscoveredService> getDiscoveredServices() const;
 
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace konflikt {
+
+/// Immutable value replaced by any thread and read by one thread without locks
+///
+/// The reader keeps its own reference and only takes the lock after a
+/// publish, so in steady state read() is a single atomic load. A replaced
+/// value is freed once the reader has moved past it, so at most two are
+/// alive at a time however often it is published. publish() must be called
+/// before the first read().
+template <typename T>
+class Snapshot
+{
+public:
+    Snapshot() = default;
+
+    // Non-copyable
+    Snapshot(const Snapshot &) = delete;
+    Snapshot &operator=(const Snapshot &) = delete;
+
+    /// Replace the value (any thread)
+    void publish(std::shared_ptr<const T> value)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mValue = std::move(value);
+        mGeneration.fetch_add(1, std::memory_order_release);
+    }
+
+    /// Current value; only one thread may read, and the reference stays
+    /// valid until its next read()
+    const T &read() const
+    {
+        if (mGeneration.load(std::memory_order_acquire) != mReadGeneration) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mRead = mValue;
+            mReadGeneration = mGeneration.load(std::memory_order_relaxed);
+        }
+        return *mRead;
+    }
+
+private:
+    mutable std::mutex mMutex;
+    std::shared_ptr<const T> mValue;  // Guarded by mMutex
+    std::atomic<uint64_t> mGeneration { 0 };  // Bumped under mMutex
+
+    // Reader thread only
+    mutable std::shared_ptr<const T> mRead;
+    mutable uint64_t mReadGeneration { 0 };
+};
+
+} // namespace konflikt
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace konflikt {
+
+/// Scheduling policy for a thread
+enum class ThreadPolicy
+{
+    Default,    // SCHED_OTHER, tuned with nice
+    Fifo,       // SCHED_FIFO real-time
+    RoundRobin  // SCHED_RR real-time
+};
+
+/// Scheduling settings for one of the library's threads
+struct ThreadOptions
+{
+    std::string name;       // Thread name shown in top/gdb (truncated to 15 chars)
+    std::vector<int> cpus;  // Pin to these CPUs (empty = any)
+    int nice { 0 };         // Nice level for the default policy; negative values need CAP_SYS_NICE
+    ThreadPolicy policy { ThreadPolicy::Default };
+    int priority { 0 };     // Real-time priority (1-99) for Fifo/RoundRobin; needs CAP_SYS_NICE
+
+    bool operator==(const ThreadOptions &) const = default;
+};
+
+/// Parse "default" (or "other"), "fifo" or "rr"
+std::optional<ThreadPolicy> parseThreadPolicy(std::string_view name);
+const char *threadPolicyName(ThreadPolicy policy);
+
+/// Apply options to the calling thread
+/// Returns false and describes what could not be applied in error; the
+/// rest of the options are still applied. Named threads are recorded so
+/// their scheduler statistics can be looked up with threadSchedStats().
+bool applyThreadOptions(const ThreadOptions &options, std::string &error);
+
+/// Run-queue statistics for one thread, cumulative since it started
+struct ThreadSchedStats
+{
+    std::string name;
+    ThreadOptions options;
+    std::string error;          // What applyThreadOptions() could not apply
+    uint64_t runNs { 0 };       // Time spent on a CPU
+    uint64_t waitNs { 0 };      // Time spent runnable but waiting for a CPU
+    uint64_t timeslices { 0 };  // Number of times it was scheduled
+};
+
+/// Scheduler statistics for every thread that applied named options
+/// Wait times come from /proc/self/task/<tid>/schedstat and are only
+/// available on Linux; elsewhere they are left at zero.
+std::vector<ThreadSchedStats> threadSchedStats();
+
+} // namespace konflikt
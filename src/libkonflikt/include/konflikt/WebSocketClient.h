@@ -1,5 +1,7 @@
 #pragma once
 
+#include "ThreadUtil.h"
+
 #include <functional>
 #include <memory>
 #include <string>
@@ -31,7 +33,21 @@ struct WebSocketClientSSLConfig
     bool verifyPeer { false };  // Whether to verify server certificate (disabled for self-signed)
 };
 
+/// Timing and TLS details of the most recent successful connect
+struct WebSocketConnectStats
+{
+    double connectMs { 0.0 };   // TCP connect, TLS handshake and HTTP upgrade
+    bool tls { false };
+    bool tlsResumed { false };  // Abbreviated handshake using the previous session ticket
+    std::string tlsVersion;
+    std::string tlsCipher;
+};
+
 /// WebSocket client using uWebSockets
+///
+/// The connection thread keeps its socket context across reconnects, so with
+/// TLS the server's session ticket is offered on the next connect and a
+/// reconnect to the same server skips the full handshake.
 class WebSocketClient
 {
 public:
@@ -48,6 +64,16 @@ public:
     /// Enable TLS for connections
     void setSSL(const WebSocketClientSSLConfig &config);
 
+    /// Name, CPU affinity and priority for the connection thread
+    /// Must be called before the first connect().
+    void setThreadOptions(ThreadOptions options);
+
+    /// Why the thread options could not be fully applied (empty on success)
+    std::string threadOptionsError() const;
+
+    /// How the last successful connect went
+    WebSocketConnectStats lastConnectStats() const;
+
     /// Connect to a server (ws:// or wss://)
     bool connect(const std::string &host, int port, const std::string &path = "/ws");
 
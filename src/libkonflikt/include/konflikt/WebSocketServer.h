@@ -1,18 +1,23 @@
 #pragma once
 
+#include "ThreadUtil.h"
+
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 
 namespace konflikt {
 
+class HttpServer;
+
 /// Callbacks for WebSocket server events
 struct WebSocketServerCallbacks
 {
     std::function<void(void *connection)> onConnect;
     std::function<void(void *connection)> onDisconnect;
-    std::function<void(const std::string &message, void *connection)> onMessage;
+    std::function<void(std::string_view message, void *connection)> onMessage;  // Valid during the call only
 };
 
 /// SSL/TLS configuration for WebSocket server
@@ -24,6 +29,10 @@ struct WebSocketServerSSLConfig
 };
 
 /// WebSocket server using uWebSockets
+///
+/// Serves `/ws` and, if set, the routes of an HttpServer from one uWS app on
+/// a single network thread, so HTTP and WebSocket traffic share one port and
+/// one event loop.
 class WebSocketServer
 {
 public:
@@ -42,6 +51,17 @@ public:
     /// Set callbacks
     void setCallbacks(WebSocketServerCallbacks callbacks);
 
+    /// Serve the routes and static files of http from the same app
+    /// Must be called before start(); http must outlive the server.
+    void setHttpServer(const HttpServer *http);
+
+    /// Name, CPU affinity and priority for the network thread
+    /// Must be called before start().
+    void setThreadOptions(ThreadOptions options);
+
+    /// Why the thread options could not be fully applied (empty on success)
+    const std::string &threadOptionsError() const { return mThreadOptionsError; }
+
     /// Start the server (non-blocking, runs in background)
     bool start();
 
@@ -49,10 +69,16 @@ public:
     void stop();
 
     /// Send message to a specific client
-    void send(void *connection, const std::string &message);
+    void send(void *connection, std::string_view message);
 
     /// Broadcast message to all clients
-    void broadcast(const std::string &message);
+    void broadcast(std::string_view message);
+
+    /// Close a client connection (e.g. an unresponsive peer)
+    void disconnect(void *connection);
+
+    /// Run task on the network thread, where connection callbacks and HTTP routes run
+    void post(std::function<void()> task);
 
     /// Get the actual port (may differ if 0 was specified)
     int port() const { return mPort; }
@@ -75,6 +101,7 @@ private:
     bool mSSLEnabled { false };
     WebSocketServerSSLConfig mSSLConfig;
     WebSocketServerCallbacks mCallbacks;
+    std::string mThreadOptionsError;
 };
 
 } // namespace konflikt
@@ -0,0 +1,34 @@
+#include "konflikt/Backoff.h"
+
+#include <algorithm>
+
+namespace konflikt {
+
+Backoff::Backoff(uint64_t baseMs, uint64_t capMs)
+    : mBaseMs(baseMs)
+    , mCapMs(std::max(baseMs, capMs))
+    , mRandom(std::random_device {}())
+{
+}
+
+uint64_t Backoff::next()
+{
+    uint64_t delay;
+    if (mAttempts == 0) {
+        delay = std::uniform_int_distribution<uint64_t>(0, mBaseMs)(mRandom);
+    } else {
+        uint64_t upper = std::max(mBaseMs, mPreviousMs * 3);
+        delay = std::min(mCapMs, std::uniform_int_distribution<uint64_t>(mBaseMs, upper)(mRandom));
+    }
+    mPreviousMs = std::max(delay, mBaseMs);
+    ++mAttempts;
+    return delay;
+}
+
+void Backoff::reset()
+{
+    mPreviousMs = 0;
+    mAttempts = 0;
+}
+
+} // namespace konflikt
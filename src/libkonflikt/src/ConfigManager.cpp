@@ -1,10 +1,15 @@
 #include "konflikt/ConfigManager.h"
 
+#include <cerrno>
+#include <cmath>
 #include <cstdlib>
+#include <fcntl.h>
 #include <filesystem>
 #include <fstream>
 #include <glaze/json.hpp>
 #include <map>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace konflikt {
 
@@ -17,6 +22,21 @@ struct DisplayEdgesJson
     bool bottom { true };
 };
 
+// Runtime state (not user settings), see ConfigManager::getStatePath
+struct StateJson
+{
+    std::vector<CachedServer> servers;
+};
+
+// Thread scheduling settings (see ThreadOptions)
+struct ThreadOptionsJson
+{
+    std::vector<int> cpus;
+    int nice { 0 };
+    std::string policy { "default" };  // default, fifo or rr
+    int priority { 0 };
+};
+
 // Glaze metadata for Config serialization
 struct ConfigJson
 {
@@ -24,6 +44,7 @@ struct ConfigJson
     std::string instanceId;
     std::string instanceName;
     int port { 3000 };
+    int maxClients { 0 };
     std::string serverHost;
     int serverPort { 3000 };
     int screenX { 0 };
@@ -47,6 +68,13 @@ struct ConfigJson
     std::map<std::string, int> keyRemap;  // String keys for JSON compatibility
     bool logKeycodes { false };
     std::map<std::string, DisplayEdgesJson> displayEdges;  // Display ID -> edge settings
+    double pointerSpeed { 1.0 };
+    double pointerAcceleration { 0.0 };
+    double pointerAccelerationThreshold { 0.5 };
+    double jitterBufferMs { 0.0 };
+    ThreadOptionsJson captureThread;
+    ThreadOptionsJson networkThread;
+    ThreadOptionsJson clientThread;
 };
 
 } // namespace konflikt
@@ -62,6 +90,39 @@ struct glz::meta<konflikt::DisplayEdgesJson>
         "bottom", &T::bottom);
 };
 
+template <>
+struct glz::meta<konflikt::CachedServer>
+{
+    using T = konflikt::CachedServer;
+    static constexpr auto value = object(
+        "host", &T::host,
+        "port", &T::port,
+        "name", &T::name,
+        "instanceId", &T::instanceId,
+        "lastSeen", &T::lastSeen,
+        "lastConnected", &T::lastConnected,
+        "rttMs", &T::rttMs,
+        "failures", &T::failures);
+};
+
+template <>
+struct glz::meta<konflikt::StateJson>
+{
+    using T = konflikt::StateJson;
+    static constexpr auto value = object("servers", &T::servers);
+};
+
+template <>
+struct glz::meta<konflikt::ThreadOptionsJson>
+{
+    using T = konflikt::ThreadOptionsJson;
+    static constexpr auto value = object(
+        "cpus", &T::cpus,
+        "nice", &T::nice,
+        "policy", &T::policy,
+        "priority", &T::priority);
+};
+
 template <>
 struct glz::meta<konflikt::ConfigJson>
 {
@@ -71,6 +132,7 @@ struct glz::meta<konflikt::ConfigJson>
         "instanceId", &T::instanceId,
         "instanceName", &T::instanceName,
         "port", &T::port,
+        "maxClients", &T::maxClients,
         "serverHost", &T::serverHost,
         "serverPort", &T::serverPort,
         "screenX", &T::screenX,
@@ -93,11 +155,91 @@ struct glz::meta<konflikt::ConfigJson>
         "enableDebugApi", &T::enableDebugApi,
         "keyRemap", &T::keyRemap,
         "logKeycodes", &T::logKeycodes,
-        "displayEdges", &T::displayEdges);
+        "displayEdges", &T::displayEdges,
+        "pointerSpeed", &T::pointerSpeed,
+        "pointerAcceleration", &T::pointerAcceleration,
+        "pointerAccelerationThreshold", &T::pointerAccelerationThreshold,
+        "jitterBufferMs", &T::jitterBufferMs,
+        "captureThread", &T::captureThread,
+        "networkThread", &T::networkThread,
+        "clientThread", &T::clientThread);
 };
 
 namespace konflikt {
 
+namespace {
+
+ThreadOptions threadOptionsFromJson(const ThreadOptionsJson &json)
+{
+    ThreadOptions options;
+    options.cpus = json.cpus;
+    options.nice = json.nice;
+    options.policy = parseThreadPolicy(json.policy).value_or(ThreadPolicy::Default);
+    options.priority = json.priority;
+    return options;
+}
+
+ThreadOptionsJson threadOptionsToJson(const ThreadOptions &options)
+{
+    ThreadOptionsJson json;
+    json.cpus = options.cpus;
+    json.nice = options.nice;
+    json.policy = threadPolicyName(options.policy);
+    json.priority = options.priority;
+    return json;
+}
+
+// Write to a temporary file next to path, flush it to disk and rename it
+// over path, so a crash leaves the old or the new file but never a torn one
+bool writeFileAtomically(const std::string &path, const std::string &content)
+{
+    std::string tempPath = path + ".tmp";
+
+    // Keep the permissions of the file being replaced
+    mode_t mode = 0666;
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0) {
+        mode = st.st_mode & 0777;
+    }
+
+    int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, mode);
+    if (fd < 0) {
+        return false;
+    }
+
+    const char *data = content.data();
+    size_t remaining = content.size();
+    while (remaining > 0) {
+        ssize_t written = write(fd, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+
+    bool ok = remaining == 0 && fsync(fd) == 0;
+    ok = close(fd) == 0 && ok;
+    if (!ok || rename(tempPath.c_str(), path.c_str()) != 0) {
+        unlink(tempPath.c_str());
+        return false;
+    }
+
+    // Make the rename itself durable
+    std::string directory = std::filesystem::path(path).parent_path().string();
+    int dirFd = open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        close(dirFd);
+    }
+    return true;
+}
+
+} // namespace
+
 std::string ConfigManager::getUserConfigPath()
 {
     std::string configDir;
@@ -176,6 +318,53 @@ std::string ConfigManager::getDefaultConfigPath()
     return userPath;
 }
 
+std::string ConfigManager::getStatePath()
+{
+    std::string configPath = getUserConfigPath();
+    if (configPath.empty()) {
+        return "";
+    }
+    return (std::filesystem::path(configPath).parent_path() / "state.json").string();
+}
+
+std::vector<CachedServer> ConfigManager::loadServerCache(const std::string &path)
+{
+    std::string statePath = path.empty() ? getStatePath() : path;
+
+    std::ifstream file(statePath);
+    if (statePath.empty() || !file.is_open()) {
+        return {};
+    }
+
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // An unreadable (or older) state file just means starting with an empty cache
+    StateJson state;
+    if (glz::read_json(state, content)) {
+        return {};
+    }
+    return state.servers;
+}
+
+bool ConfigManager::saveServerCache(const std::vector<CachedServer> &servers, const std::string &path)
+{
+    std::string statePath = path.empty() ? getStatePath() : path;
+    if (statePath.empty()) {
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(statePath).parent_path(), ec);
+
+    StateJson state { servers };
+    auto json = glz::write_json(state);
+    if (!json) {
+        return false;
+    }
+
+    return writeFileAtomically(statePath, glz::prettify_json(*json));
+}
+
 std::optional<Config> ConfigManager::load(const std::string &path)
 {
     std::string configPath = path.empty() ? getDefaultConfigPath() : path;
@@ -204,6 +393,7 @@ std::optional<Config> ConfigManager::load(const std::string &path)
     config.instanceName = jsonConfig.instanceName;
     config.port = jsonConfig.port;
     config.serverHost = jsonConfig.serverHost;
+    config.maxClients = jsonConfig.maxClients;
     config.serverPort = jsonConfig.serverPort;
     config.screenX = jsonConfig.screenX;
     config.screenY = jsonConfig.screenY;
@@ -237,6 +427,24 @@ std::optional<Config> ConfigManager::load(const std::string &path)
 
     config.logKeycodes = jsonConfig.logKeycodes;
 
+    // Out-of-range values keep their defaults; a speed of 0 would freeze the remote cursor
+    if (std::isfinite(jsonConfig.pointerSpeed) && jsonConfig.pointerSpeed > 0) {
+        config.pointerSpeed = jsonConfig.pointerSpeed;
+    }
+    if (std::isfinite(jsonConfig.pointerAcceleration) && jsonConfig.pointerAcceleration >= 0) {
+        config.pointerAcceleration = jsonConfig.pointerAcceleration;
+    }
+    if (std::isfinite(jsonConfig.pointerAccelerationThreshold) && jsonConfig.pointerAccelerationThreshold >= 0) {
+        config.pointerAccelerationThreshold = jsonConfig.pointerAccelerationThreshold;
+    }
+    if (std::isfinite(jsonConfig.jitterBufferMs) && jsonConfig.jitterBufferMs >= 0) {
+        config.jitterBufferMs = jsonConfig.jitterBufferMs;
+    }
+
+    config.captureThread = threadOptionsFromJson(jsonConfig.captureThread);
+    config.networkThread = threadOptionsFromJson(jsonConfig.networkThread);
+    config.clientThread = threadOptionsFromJson(jsonConfig.clientThread);
+
     // Convert string keys to uint32_t for displayEdges
     for (const auto &[key, edges] : jsonConfig.displayEdges) {
         try {
@@ -279,6 +487,7 @@ bool ConfigManager::save(const Config &config, const std::string &path)
     jsonConfig.instanceName = config.instanceName;
     jsonConfig.port = config.port;
     jsonConfig.serverHost = config.serverHost;
+    jsonConfig.maxClients = config.maxClients;
     jsonConfig.serverPort = config.serverPort;
     jsonConfig.screenX = config.screenX;
     jsonConfig.screenY = config.screenY;
@@ -305,6 +514,13 @@ bool ConfigManager::save(const Config &config, const std::string &path)
     }
 
     jsonConfig.logKeycodes = config.logKeycodes;
+    jsonConfig.pointerSpeed = config.pointerSpeed;
+    jsonConfig.pointerAcceleration = config.pointerAcceleration;
+    jsonConfig.pointerAccelerationThreshold = config.pointerAccelerationThreshold;
+    jsonConfig.jitterBufferMs = config.jitterBufferMs;
+    jsonConfig.captureThread = threadOptionsToJson(config.captureThread);
+    jsonConfig.networkThread = threadOptionsToJson(config.networkThread);
+    jsonConfig.clientThread = threadOptionsToJson(config.clientThread);
 
     // Convert uint32_t keys to string for displayEdges
     for (const auto &[displayId, edges] : config.displayEdges) {
@@ -322,17 +538,7 @@ bool ConfigManager::save(const Config &config, const std::string &path)
     }
 
     // Pretty print with indentation
-    std::string prettyJson = glz::prettify_json(*json);
-
-    std::ofstream file(configPath);
-    if (!file.is_open()) {
-        return false;
-    }
-
-    file << prettyJson;
-    file.close();
-
-    return true;
+    return writeFileAtomically(configPath, glz::prettify_json(*json));
 }
 
 Config ConfigManager::merge(const Config &fileConfig, const Config &cmdLineConfig)
@@ -0,0 +1,176 @@
+#include "konflikt/ConfigWatcher.h"
+
+#include <filesystem>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#elif defined(__APPLE__)
+#include <sys/event.h>
+#endif
+
+namespace konflikt {
+
+ConfigWatcher::~ConfigWatcher()
+{
+    stop();
+}
+
+#ifdef __linux__
+
+bool ConfigWatcher::start(const std::string &path)
+{
+    stop();
+
+    std::filesystem::path file(path);
+    std::string directory = file.parent_path().empty() ? "." : file.parent_path().string();
+
+    mHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (mHandle < 0) {
+        return false;
+    }
+
+    // Written in place, or replaced by rename
+    mDirectory = inotify_add_watch(mHandle, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (mDirectory < 0) {
+        stop();
+        return false;
+    }
+
+    mPath = path;
+    mFileName = file.filename().string();
+    return true;
+}
+
+void ConfigWatcher::stop()
+{
+    if (mHandle >= 0) {
+        close(mHandle);
+        mHandle = -1;
+    }
+    mDirectory = -1;
+}
+
+bool ConfigWatcher::poll()
+{
+    if (mHandle < 0) {
+        return false;
+    }
+
+    // Drain everything queued; only events for our file count
+    bool changed = false;
+    alignas(inotify_event) char buffer[4096];
+    ssize_t length;
+    while ((length = read(mHandle, buffer, sizeof(buffer))) > 0) {
+        for (char *ptr = buffer; ptr < buffer + length;) {
+            const auto *event = reinterpret_cast<const inotify_event *>(ptr);
+            if (event->len > 0 && mFileName == event->name) {
+                changed = true;
+            }
+            ptr += sizeof(inotify_event) + event->len;
+        }
+    }
+    return changed;
+}
+
+#elif defined(__APPLE__)
+
+namespace {
+
+bool watch(int queue, int fd, unsigned int flags)
+{
+    struct kevent change;
+    EV_SET(&change, fd, EVFILT_VNODE, EV_ADD | EV_CLEAR, flags, 0, nullptr);
+    return kevent(queue, &change, 1, nullptr, 0, nullptr) == 0;
+}
+
+} // namespace
+
+bool ConfigWatcher::start(const std::string &path)
+{
+    stop();
+
+    std::filesystem::path file(path);
+    std::string directory = file.parent_path().empty() ? "." : file.parent_path().string();
+
+    mHandle = kqueue();
+    if (mHandle < 0) {
+        return false;
+    }
+
+    // The directory changes when the file is replaced by rename
+    mDirectory = open(directory.c_str(), O_EVTONLY | O_CLOEXEC);
+    if (mDirectory < 0 || !watch(mHandle, mDirectory, NOTE_WRITE)) {
+        stop();
+        return false;
+    }
+
+    mPath = path;
+    mFileName = file.filename().string();
+    mFile = open(mPath.c_str(), O_EVTONLY | O_CLOEXEC);
+    if (mFile >= 0) {
+        watch(mHandle, mFile, NOTE_WRITE | NOTE_EXTEND | NOTE_DELETE | NOTE_RENAME);
+    }
+    return true;
+}
+
+void ConfigWatcher::stop()
+{
+    // Closing a descriptor removes its kevents
+    for (int *fd : { &mFile, &mDirectory, &mHandle }) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+bool ConfigWatcher::poll()
+{
+    if (mHandle < 0) {
+        return false;
+    }
+
+    bool changed = false;
+    struct kevent events[8];
+    struct timespec timeout = { 0, 0 };
+    int count;
+    while ((count = kevent(mHandle, nullptr, 0, events, 8, &timeout)) > 0) {
+        changed = true;
+    }
+
+    // A rename leaves us watching the old file
+    if (changed) {
+        if (mFile >= 0) {
+            close(mFile);
+        }
+        mFile = open(mPath.c_str(), O_EVTONLY | O_CLOEXEC);
+        if (mFile >= 0) {
+            watch(mHandle, mFile, NOTE_WRITE | NOTE_EXTEND | NOTE_DELETE | NOTE_RENAME);
+        }
+    }
+    return changed;
+}
+
+#else
+
+bool ConfigWatcher::start(const std::string &path)
+{
+    (void)path;
+    return false;
+}
+
+void ConfigWatcher::stop()
+{
+}
+
+bool ConfigWatcher::poll()
+{
+    return false;
+}
+
+#endif
+
+} // namespace konflikt
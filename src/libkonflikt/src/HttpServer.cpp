@@ -1,11 +1,8 @@
 #include "konflikt/HttpServer.h"
 
-#include <App.h>
-#include <atomic>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
-#include <mutex>
-#include <thread>
 #include <unordered_map>
 
 namespace konflikt {
@@ -54,197 +51,49 @@ std::string readFile(const std::string &path)
 
 } // namespace
 
-struct HttpServer::Impl
-{
-    std::thread serverThread;
-    std::atomic<bool> running { false };
-    us_listen_socket_t *listenSocket { nullptr };
-    uWS::Loop *loop { nullptr };
-
-    std::unordered_map<std::string, RouteHandler> routes;
-    std::string staticDir;
-    std::string staticPrefix;
-    int port { 0 };
-
-    void run(int requestedPort)
-    {
-        uWS::App app;
-
-        // Serve static files
-        if (!staticDir.empty()) {
-            app.get(staticPrefix + "*", [this](auto *res, auto *req) {
-                std::string urlPath(req->getUrl());
-
-                // Remove prefix to get relative path
-                std::string relativePath = urlPath.substr(staticPrefix.length());
-                if (relativePath.empty() || relativePath == "/") {
-                    relativePath = "index.html";
-                }
-
-                std::string filePath = staticDir + "/" + relativePath;
-
-                // Security: prevent directory traversal
-                auto canonical = std::filesystem::weakly_canonical(filePath);
-                auto staticCanonical = std::filesystem::weakly_canonical(staticDir);
-                if (canonical.string().find(staticCanonical.string()) != 0) {
-                    res->writeStatus("403 Forbidden")->end("Forbidden");
-                    return;
-                }
-
-                if (!std::filesystem::exists(filePath)) {
-                    res->writeStatus("404 Not Found")->end("Not Found");
-                    return;
-                }
-
-                std::string content = readFile(filePath);
-                std::string mimeType = getMimeType(filePath);
-
-                res->writeHeader("Content-Type", mimeType);
-                res->end(content);
-            });
-        }
-
-        // Redirect root to UI
-        app.get("/", [this](auto *res, auto * /*req*/) {
-            if (!staticPrefix.empty()) {
-                res->writeStatus("302 Found");
-                res->writeHeader("Location", staticPrefix);
-                res->end();
-            } else {
-                res->end("Konflikt Server");
-            }
-        });
-
-        // Custom routes
-        for (const auto &[key, handler] : routes) {
-            // Parse method and path from key (format: "METHOD /path")
-            auto spacePos = key.find(' ');
-            if (spacePos == std::string::npos)
-                continue;
-
-            std::string method = key.substr(0, spacePos);
-            std::string path = key.substr(spacePos + 1);
-
-            auto routeHandler = [handler](auto *res, auto *req) {
-                HttpRequest httpReq;
-                httpReq.method = std::string(req->getMethod());
-                httpReq.path = std::string(req->getUrl());
-                httpReq.query = std::string(req->getQuery());
-
-                // Get commonly used headers
-                auto contentType = req->getHeader("content-type");
-                if (!contentType.empty()) {
-                    httpReq.headers["content-type"] = std::string(contentType);
-                }
-                auto accept = req->getHeader("accept");
-                if (!accept.empty()) {
-                    httpReq.headers["accept"] = std::string(accept);
-                }
-
-                HttpResponse httpRes = handler(httpReq);
-
-                res->writeStatus(std::to_string(httpRes.statusCode) + " " + httpRes.statusMessage);
-                res->writeHeader("Content-Type", httpRes.contentType);
-                for (const auto &[hkey, hvalue] : httpRes.headers) {
-                    res->writeHeader(hkey, hvalue);
-                }
-                res->end(httpRes.body);
-            };
-
-            if (method == "GET") {
-                app.get(path, routeHandler);
-            } else if (method == "POST") {
-                app.post(path, routeHandler);
-            } else if (method == "PUT") {
-                app.put(path, routeHandler);
-            } else if (method == "DELETE") {
-                app.del(path, routeHandler);
-            }
-        }
-
-        app.listen(requestedPort, [this](us_listen_socket_t *socket) {
-            if (socket) {
-                listenSocket = socket;
-                port = us_socket_local_port(false, reinterpret_cast<us_socket_t *>(socket));
-                running = true;
-            } else {
-                port = 0;
-            }
-        });
-
-        loop = uWS::Loop::get();
-        app.run();
-
-        running = false;
-    }
-};
-
-HttpServer::HttpServer(int port)
-    : mImpl(std::make_unique<Impl>())
-    , mPort(port)
-{
-}
-
-HttpServer::~HttpServer()
-{
-    stop();
-}
-
 void HttpServer::route(const std::string &method, const std::string &path, RouteHandler handler)
 {
-    mImpl->routes[method + " " + path] = std::move(handler);
+    mRoutes[method + " " + path] = std::move(handler);
 }
 
 void HttpServer::serveStatic(const std::string &urlPrefix, const std::string &directory)
 {
-    mImpl->staticPrefix = urlPrefix;
-    mImpl->staticDir = directory;
-    mStaticDir = directory;
     mStaticPrefix = urlPrefix;
+    mStaticDir = directory;
 }
 
-bool HttpServer::start()
+HttpResponse HttpServer::serveStaticFile(const std::string &urlPath) const
 {
-    if (mRunning) {
-        return true;
-    }
+    HttpResponse response;
 
-    mImpl->serverThread = std::thread([this]() {
-        mImpl->run(mPort);
-    });
-
-    // Wait for server to start
-    while (!mImpl->running && mImpl->serverThread.joinable()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        if (mImpl->port == 0 && mImpl->listenSocket == nullptr) {
-            break;
-        }
+    // Remove prefix to get relative path
+    std::string relativePath = urlPath.substr(std::min(mStaticPrefix.length(), urlPath.length()));
+    if (relativePath.empty() || relativePath == "/") {
+        relativePath = "index.html";
     }
 
-    mRunning = mImpl->running;
-    if (mRunning) {
-        mPort = mImpl->port;
-    }
-    return mRunning;
-}
+    std::string filePath = mStaticDir + "/" + relativePath;
 
-void HttpServer::stop()
-{
-    if (!mRunning) {
-        return;
+    // Security: prevent directory traversal
+    auto canonical = std::filesystem::weakly_canonical(filePath);
+    auto staticCanonical = std::filesystem::weakly_canonical(mStaticDir);
+    if (canonical.string().find(staticCanonical.string()) != 0) {
+        response.statusCode = 403;
+        response.statusMessage = "Forbidden";
+        response.body = "Forbidden";
+        return response;
     }
 
-    mRunning = false;
-    mImpl->running = false;
-
-    if (mImpl->listenSocket) {
-        us_listen_socket_close(false, mImpl->listenSocket);
-        mImpl->listenSocket = nullptr;
+    if (!std::filesystem::exists(filePath)) {
+        response.statusCode = 404;
+        response.statusMessage = "Not Found";
+        response.body = "Not Found";
+        return response;
     }
 
-    if (mImpl->serverThread.joinable()) {
-        mImpl->serverThread.join();
-    }
+    response.body = readFile(filePath);
+    response.contentType = getMimeType(filePath);
+    return response;
 }
 
 } // namespace konflikt
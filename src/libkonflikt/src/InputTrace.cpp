@@ -0,0 +1,178 @@
+#include "konflikt/InputTrace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace konflikt {
+
+namespace {
+
+constexpr char TRACE_MAGIC[8] = { 'K', 'F', 'T', 'R', 'A', 'C', 'E', '\0' };
+
+} // namespace
+
+InputTraceWriter::~InputTraceWriter()
+{
+    close();
+}
+
+bool InputTraceWriter::open(const std::string &path)
+{
+    close();
+
+    mFile = fopen(path.c_str(), "wb");
+    if (!mFile) {
+        return false;
+    }
+
+    // Large buffer so appends from the capture thread rarely hit the disk
+    setvbuf(mFile, nullptr, _IOFBF, 256 * 1024);
+
+    TraceHeader header {};
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.recordSize = sizeof(TraceRecord);
+    header.startTime = timestamp();
+
+    if (fwrite(&header, sizeof(header), 1, mFile) != 1) {
+        fclose(mFile);
+        mFile = nullptr;
+        return false;
+    }
+
+    mStart = std::chrono::steady_clock::now();
+    mRecordCount = 0;
+    return true;
+}
+
+void InputTraceWriter::close()
+{
+    if (mFile) {
+        fclose(mFile);
+        mFile = nullptr;
+    }
+}
+
+void InputTraceWriter::append(const Event &event)
+{
+    if (!mFile) {
+        return;
+    }
+
+    TraceRecord record;
+    record.offsetNs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - mStart)
+            .count());
+    record.timestamp = event.timestamp;
+    record.x = event.state.x;
+    record.y = event.state.y;
+    record.dx = event.state.dx;
+    record.dy = event.state.dy;
+    record.scrollX = event.state.scrollX;
+    record.scrollY = event.state.scrollY;
+    record.keyboardModifiers = event.state.keyboardModifiers;
+    record.mouseButtons = event.state.mouseButtons;
+    record.keycode = event.keycode;
+    record.type = static_cast<uint8_t>(event.type);
+    record.button = static_cast<uint16_t>(event.button);
+    record.hidUsage = event.hidUsage;
+
+    size_t textLength = std::min(event.text.size(), sizeof(record.text));
+    memcpy(record.text, event.text.data(), textLength);
+    record.textLength = static_cast<uint8_t>(textLength);
+
+    if (fwrite(&record, sizeof(record), 1, mFile) == 1) {
+        mRecordCount++;
+    }
+}
+
+InputTraceReader::~InputTraceReader()
+{
+    close();
+}
+
+bool InputTraceReader::open(const std::string &path)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(TraceHeader)) {
+        ::close(fd);
+        return false;
+    }
+
+    void *data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    mData = data;
+    mSize = static_cast<size_t>(st.st_size);
+
+    const TraceHeader &hdr = header();
+    if (memcmp(hdr.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 ||
+        hdr.version != TRACE_VERSION ||
+        hdr.recordSize != sizeof(TraceRecord)) {
+        close();
+        return false;
+    }
+
+    // A recording that was cut short may end in a partial record; ignore it
+    mRecordCount = (mSize - sizeof(TraceHeader)) / sizeof(TraceRecord);
+
+    // Replay reads records strictly in order
+    madvise(mData, mSize, MADV_SEQUENTIAL);
+    return true;
+}
+
+void InputTraceReader::close()
+{
+    if (mData) {
+        munmap(mData, mSize);
+        mData = nullptr;
+    }
+    mSize = 0;
+    mRecordCount = 0;
+}
+
+const TraceRecord &InputTraceReader::record(size_t index) const
+{
+    const auto *records = reinterpret_cast<const TraceRecord *>(
+        static_cast<const char *>(mData) + sizeof(TraceHeader));
+    return records[index];
+}
+
+Event InputTraceReader::event(size_t index) const
+{
+    const TraceRecord &rec = record(index);
+
+    Event event;
+    event.type = static_cast<EventType>(rec.type);
+    event.timestamp = rec.timestamp;
+    event.state.x = rec.x;
+    event.state.y = rec.y;
+    event.state.dx = rec.dx;
+    event.state.dy = rec.dy;
+    event.state.scrollX = rec.scrollX;
+    event.state.scrollY = rec.scrollY;
+    event.state.keyboardModifiers = rec.keyboardModifiers;
+    event.state.mouseButtons = rec.mouseButtons;
+    event.keycode = rec.keycode;
+    event.button = static_cast<MouseButton>(rec.button);
+    event.hidUsage = rec.hidUsage;
+    event.text.assign({ rec.text, std::min<size_t>(rec.textLength, sizeof(rec.text)) });
+    return event;
+}
+
+} // namespace konflikt
@@ -0,0 +1,96 @@
+#include "konflikt/InstanceRegistry.h"
+
+namespace konflikt {
+
+namespace {
+
+InstanceHandle makeHandle(size_t slot, uint16_t generation)
+{
+    return (static_cast<InstanceHandle>(generation) << 16) | static_cast<InstanceHandle>(slot);
+}
+
+} // namespace
+
+InstanceHandle InstanceRegistry::intern(std::string_view id)
+{
+    if (id.empty()) {
+        return NO_INSTANCE;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mHandles.find(id);
+    if (it != mHandles.end()) {
+        return it->second;
+    }
+
+    size_t index;
+    if (!mFreeSlots.empty()) {
+        index = mFreeSlots.back();
+        mFreeSlots.pop_back();
+    } else if (mSlots.size() < MAX_INSTANCES) {
+        index = mSlots.size();
+        mSlots.emplace_back();
+    } else {
+        return NO_INSTANCE;
+    }
+
+    Slot &slot = mSlots[index];
+    slot.id = std::string(id);
+    slot.used = true;
+    InstanceHandle handle = makeHandle(index, slot.generation);
+    mHandles.emplace(slot.id, handle);
+    return handle;
+}
+
+InstanceHandle InstanceRegistry::find(std::string_view id) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mHandles.find(id);
+    return it != mHandles.end() ? it->second : NO_INSTANCE;
+}
+
+void InstanceRegistry::release(InstanceHandle handle)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    size_t index = instanceSlot(handle);
+    if (handle == NO_INSTANCE || index >= mSlots.size()) {
+        return;
+    }
+
+    Slot &slot = mSlots[index];
+    if (!slot.used || makeHandle(index, slot.generation) != handle) {
+        return;
+    }
+
+    mHandles.erase(slot.id);
+    slot.id.clear();
+    slot.used = false;
+    // Generation 0 would let slot 0 produce NO_INSTANCE
+    if (++slot.generation == 0) {
+        slot.generation = 1;
+    }
+    mFreeSlots.push_back(static_cast<uint16_t>(index));
+}
+
+std::string InstanceRegistry::id(InstanceHandle handle) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    size_t index = instanceSlot(handle);
+    if (handle == NO_INSTANCE || index >= mSlots.size()) {
+        return {};
+    }
+
+    const Slot &slot = mSlots[index];
+    if (!slot.used || makeHandle(index, slot.generation) != handle) {
+        return {};
+    }
+    return slot.id;
+}
+
+size_t InstanceRegistry::size() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mHandles.size();
+}
+
+} // namespace konflikt
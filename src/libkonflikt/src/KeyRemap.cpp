@@ -0,0 +1,52 @@
+#include "konflikt/KeyRemap.h"
+
+#include <algorithm>
+
+namespace konflikt {
+
+std::span<const KeyRemapEntry> keyRemapPreset(std::string_view name)
+{
+    if (name == "mac-to-linux") {
+        return keyremap::MAC_TO_LINUX;
+    }
+    if (name == "linux-to-mac") {
+        return keyremap::LINUX_TO_MAC;
+    }
+    return {};
+}
+
+KeyRemapTable::KeyRemapTable()
+{
+    for (uint32_t i = 0; i < TABLE_SIZE; ++i) {
+        mTable[i] = i;
+    }
+}
+
+KeyRemapTable::KeyRemapTable(const std::unordered_map<uint32_t, uint32_t> &mappings)
+    : KeyRemapTable()
+{
+    for (const auto &[from, to] : mappings) {
+        if (from < TABLE_SIZE) {
+            mTable[from] = to;
+        } else {
+            mFallback.push_back({ from, to });
+        }
+    }
+
+    std::sort(mFallback.begin(), mFallback.end(), [](const KeyRemapEntry &a, const KeyRemapEntry &b) {
+        return a.from < b.from;
+    });
+}
+
+uint32_t KeyRemapTable::remapFallback(uint32_t keycode) const
+{
+    auto it = std::lower_bound(mFallback.begin(), mFallback.end(), keycode, [](const KeyRemapEntry &entry, uint32_t code) {
+        return entry.from < code;
+    });
+    if (it != mFallback.end() && it->from == keycode) {
+        return it->to;
+    }
+    return keycode;
+}
+
+} // namespace konflikt
@@ -1,7 +1,11 @@
 #include "konflikt/Konflikt.h"
 #include "konflikt/ConfigManager.h"
+#include "konflikt/ConfigWatcher.h"
 #include "konflikt/HttpServer.h"
+#include "konflikt/InputTrace.h"
+#include "konflikt/KeyCodes.h"
 #include "konflikt/LayoutManager.h"
+#include "konflikt/NetworkMonitor.h"
 #include "konflikt/ServiceDiscovery.h"
 #include "konflikt/Version.h"
 #include "konflikt/WebSocketClient.h"
@@ -11,9 +15,11 @@
 #include <filesystem>
 #include <fstream>
 #include <functional>
+#include <future>
 #include <glaze/json.hpp>
 #include <iomanip>
 #include <openssl/sha.h>
+#include <random>
 #include <sstream>
 #include <thread>
 #include <unistd.h>
@@ -29,6 +35,20 @@ struct LatencyStatsJson
     uint64_t samples {};
 };
 
+struct ThreadStatsJson
+{
+    std::string name;
+    std::string policy;
+    int priority {};
+    int nice {};
+    std::vector<int> cpus;
+    double runMs {};
+    double waitMs {};          // Runnable but waiting for a CPU
+    uint64_t timeslices {};
+    double avgWaitUs {};       // Average wait per timeslice (scheduling latency)
+    std::string error;
+};
+
 struct StatsJson
 {
     uint64_t totalEvents {};
@@ -37,6 +57,7 @@ struct StatsJson
     uint64_t scrollEvents {};
     double eventsPerSecond {};
     LatencyStatsJson latency;
+    std::vector<ThreadStatsJson> threads;
 };
 
 struct RuntimeConfigJson
@@ -50,6 +71,10 @@ struct RuntimeConfigJson
     bool verbose {};
     bool logKeycodes {};
     std::map<std::string, uint32_t> keyRemap;
+    double pointerSpeed {};
+    double pointerAcceleration {};
+    double pointerAccelerationThreshold {};
+    double jitterBufferMs {};
 };
 
 // For partial updates via POST /api/config
@@ -62,6 +87,9 @@ struct ConfigUpdateJson
     std::optional<bool> lockCursorToScreen;
     std::optional<bool> verbose;
     std::optional<bool> logKeycodes;
+    std::optional<double> pointerSpeed;
+    std::optional<double> pointerAcceleration;
+    std::optional<double> pointerAccelerationThreshold;
 };
 
 // For POST /api/keyremap
@@ -90,13 +118,18 @@ struct KeyRemapListJson
     std::vector<KeyRemapEntryJson> mappings;
 };
 
-// For GET /api/servers (discovered servers)
+// For GET /api/servers (cached and discovered servers, best first)
 struct DiscoveredServerJson
 {
     std::string name;
     std::string host;
     int port {};
     std::string instanceId;
+    bool discovered {};       // Currently announced over mDNS
+    uint64_t lastSeen {};
+    uint64_t lastConnected {};
+    double rttMs { -1.0 };
+    int failures {};
 };
 
 struct DiscoveredServersJson
@@ -185,9 +218,13 @@ struct ConnectionStatusJson
     std::string serverHost;
     int serverPort {};
     std::string serverName;
-    int reconnectAttempts {};
-    int maxReconnectAttempts {};
+    int reconnectAttempts {};      // Since the last successful connection
+    int64_t nextReconnectMs {};    // Until the next attempt, -1 if none is scheduled
     bool expectingReconnect {};
+    double connectMs {};           // Duration of the last connect, including the TLS handshake
+    bool tls {};
+    bool tlsResumed {};            // Last connect resumed a TLS session
+    std::string tlsCipher;
 };
 
 struct LogEntryJson
@@ -221,6 +258,20 @@ struct ServerInfoJson
     bool tls {};
 };
 
+struct LinkQualityJson
+{
+    double rttMs {};
+    double lastRttMs {};
+    double jitterMs {};
+    uint64_t heartbeatsSent {};
+    uint64_t heartbeatsAcked {};
+    uint64_t heartbeatsLost {};
+    uint64_t stalls {};
+    double maxStallMs {};
+    double silenceMs {};
+    bool degraded {};
+};
+
 struct ClientInfoJson
 {
     std::string instanceId;
@@ -229,6 +280,22 @@ struct ClientInfoJson
     int32_t screenHeight {};
     uint64_t connectedAt {};
     bool active {};
+    bool online {};  // False while a dropped client's session waits to be resumed
+    std::optional<LinkQualityJson> link;
+};
+
+// Startup timeline for GET /api/status (ms since init() began)
+struct StartupStepJson
+{
+    std::string name;
+    double startMs {};
+    double durationMs {};
+};
+
+struct StartupJson
+{
+    double readyMs {};  // Main loop running, 0 while starting
+    std::vector<StartupStepJson> steps;
 };
 
 struct StatusJson
@@ -249,6 +316,7 @@ struct StatusJson
     std::optional<std::string> serverHost;
     std::optional<int> serverPort;
     std::optional<std::string> connectedServer;
+    StartupJson startup;
 };
 
 } // namespace konflikt
@@ -264,6 +332,23 @@ struct glz::meta<konflikt::LatencyStatsJson>
         "samples", &T::samples);
 };
 
+template <>
+struct glz::meta<konflikt::ThreadStatsJson>
+{
+    using T = konflikt::ThreadStatsJson;
+    static constexpr auto value = object(
+        "name", &T::name,
+        "policy", &T::policy,
+        "priority", &T::priority,
+        "nice", &T::nice,
+        "cpus", &T::cpus,
+        "runMs", &T::runMs,
+        "waitMs", &T::waitMs,
+        "timeslices", &T::timeslices,
+        "avgWaitUs", &T::avgWaitUs,
+        "error", &T::error);
+};
+
 template <>
 struct glz::meta<konflikt::StatsJson>
 {
@@ -274,7 +359,8 @@ struct glz::meta<konflikt::StatsJson>
         "keyEvents", &T::keyEvents,
         "scrollEvents", &T::scrollEvents,
         "eventsPerSecond", &T::eventsPerSecond,
-        "latency", &T::latency);
+        "latency", &T::latency,
+        "threads", &T::threads);
 };
 
 template <>
@@ -290,7 +376,11 @@ struct glz::meta<konflikt::RuntimeConfigJson>
         "lockCursorHotkey", &T::lockCursorHotkey,
         "verbose", &T::verbose,
         "logKeycodes", &T::logKeycodes,
-        "keyRemap", &T::keyRemap);
+        "keyRemap", &T::keyRemap,
+        "pointerSpeed", &T::pointerSpeed,
+        "pointerAcceleration", &T::pointerAcceleration,
+        "pointerAccelerationThreshold", &T::pointerAccelerationThreshold,
+        "jitterBufferMs", &T::jitterBufferMs);
 };
 
 template <>
@@ -304,7 +394,10 @@ struct glz::meta<konflikt::ConfigUpdateJson>
         "edgeBottom", &T::edgeBottom,
         "lockCursorToScreen", &T::lockCursorToScreen,
         "verbose", &T::verbose,
-        "logKeycodes", &T::logKeycodes);
+        "logKeycodes", &T::logKeycodes,
+        "pointerSpeed", &T::pointerSpeed,
+        "pointerAcceleration", &T::pointerAcceleration,
+        "pointerAccelerationThreshold", &T::pointerAccelerationThreshold);
 };
 
 template <>
@@ -346,7 +439,12 @@ struct glz::meta<konflikt::DiscoveredServerJson>
         "name", &T::name,
         "host", &T::host,
         "port", &T::port,
-        "instanceId", &T::instanceId);
+        "instanceId", &T::instanceId,
+        "discovered", &T::discovered,
+        "lastSeen", &T::lastSeen,
+        "lastConnected", &T::lastConnected,
+        "rttMs", &T::rttMs,
+        "failures", &T::failures);
 };
 
 template <>
@@ -456,8 +554,12 @@ struct glz::meta<konflikt::ConnectionStatusJson>
         "serverPort", &T::serverPort,
         "serverName", &T::serverName,
         "reconnectAttempts", &T::reconnectAttempts,
-        "maxReconnectAttempts", &T::maxReconnectAttempts,
-        "expectingReconnect", &T::expectingReconnect);
+        "nextReconnectMs", &T::nextReconnectMs,
+        "expectingReconnect", &T::expectingReconnect,
+        "connectMs", &T::connectMs,
+        "tls", &T::tls,
+        "tlsResumed", &T::tlsResumed,
+        "tlsCipher", &T::tlsCipher);
 };
 
 template <>
@@ -504,6 +606,23 @@ struct glz::meta<konflikt::ServerInfoJson>
         "tls", &T::tls);
 };
 
+template <>
+struct glz::meta<konflikt::LinkQualityJson>
+{
+    using T = konflikt::LinkQualityJson;
+    static constexpr auto value = object(
+        "rttMs", &T::rttMs,
+        "lastRttMs", &T::lastRttMs,
+        "jitterMs", &T::jitterMs,
+        "heartbeatsSent", &T::heartbeatsSent,
+        "heartbeatsAcked", &T::heartbeatsAcked,
+        "heartbeatsLost", &T::heartbeatsLost,
+        "stalls", &T::stalls,
+        "maxStallMs", &T::maxStallMs,
+        "silenceMs", &T::silenceMs,
+        "degraded", &T::degraded);
+};
+
 template <>
 struct glz::meta<konflikt::ClientInfoJson>
 {
@@ -514,7 +633,9 @@ struct glz::meta<konflikt::ClientInfoJson>
         "screenWidth", &T::screenWidth,
         "screenHeight", &T::screenHeight,
         "connectedAt", &T::connectedAt,
-        "active", &T::active);
+        "active", &T::active,
+        "online", &T::online,
+        "link", &T::link);
 };
 
 template <>
@@ -535,11 +656,59 @@ struct glz::meta<konflikt::StatusJson>
         "clients", &T::clients,
         "serverHost", &T::serverHost,
         "serverPort", &T::serverPort,
-        "connectedServer", &T::connectedServer);
+        "connectedServer", &T::connectedServer,
+        "startup", &T::startup);
+};
+
+template <>
+struct glz::meta<konflikt::StartupStepJson>
+{
+    using T = konflikt::StartupStepJson;
+    static constexpr auto value = object(
+        "name", &T::name,
+        "startMs", &T::startMs,
+        "durationMs", &T::durationMs);
+};
+
+template <>
+struct glz::meta<konflikt::StartupJson>
+{
+    using T = konflikt::StartupJson;
+    static constexpr auto value = object(
+        "readyMs", &T::readyMs,
+        "steps", &T::steps);
 };
 
+// Set by the build
+#ifndef KONFLIKT_GIT_COMMIT
+#define KONFLIKT_GIT_COMMIT ""
+#endif
+
 namespace konflikt {
 
+namespace {
+
+// What this build speaks; a server lacking any of these can't serve this client
+const std::vector<std::string> PROTOCOL_CAPABILITIES = { "input_events", "screen_info" };
+
+// Advertised too, but peers without it are still served: they just aren't
+// held to the heartbeat's dead-peer timeout
+const std::string HEARTBEAT_CAPABILITY = "heartbeat";
+
+std::vector<std::string> advertisedCapabilities()
+{
+    std::vector<std::string> capabilities = PROTOCOL_CAPABILITIES;
+    capabilities.push_back(HEARTBEAT_CAPABILITY);
+    return capabilities;
+}
+
+bool hasCapability(const std::vector<std::string> &capabilities, const std::string &capability)
+{
+    return std::find(capabilities.begin(), capabilities.end(), capability) != capabilities.end();
+}
+
+} // namespace
+
 Konflikt::Konflikt(const Config &config)
     : mConfig(config)
 {
@@ -560,6 +729,11 @@ Konflikt::Konflikt(const Config &config)
         gethostname(hostname, sizeof(hostname));
         mConfig.instanceName = hostname;
     }
+
+    rebuildKeyRemap();
+    rebuildEdges();
+    rebuildPointerCurve();
+    mLockCursorHotkey = mConfig.lockCursorHotkey;
 }
 
 Konflikt::~Konflikt()
@@ -569,6 +743,8 @@ Konflikt::~Konflikt()
 
 bool Konflikt::init()
 {
+    mStartupBegin = std::chrono::steady_clock::now();
+
     // Set up logger
     mLogger.verbose = [this](const std::string &msg) {
         log("verbose", msg);
@@ -583,22 +759,46 @@ bool Konflikt::init()
         log("error", msg);
     };
 
+    // Startup steps that don't need the display run while the platform
+    // connects to it (the platform stays on this thread, which macOS needs)
+    std::future<void> discovery = std::async(std::launch::async, [this]() {
+        timeStartupStep("discovery", [this]() {
+            initServiceDiscovery();
+        });
+    });
+    std::future<void> serverCache;
+    if (mConfig.role == InstanceRole::Client && mConfig.serverHost.empty()) {
+        serverCache = std::async(std::launch::async, [this]() {
+            timeStartupStep("server cache", [this]() {
+                std::vector<CachedServer> servers = ConfigManager::loadServerCache();
+                std::lock_guard<std::mutex> lock(mServerCacheMutex);
+                mServerCache.assign(std::move(servers), timestamp());
+            });
+        });
+    }
+
     // Create platform
-    mPlatform = createPlatform();
-    if (!mPlatform || !mPlatform->initialize(mLogger)) {
+    bool platformReady = false;
+    timeStartupStep("platform", [this, &platformReady]() {
+        mPlatform = createPlatform();
+        platformReady = mPlatform && mPlatform->initialize(mLogger);
+    });
+    if (!platformReady) {
         log("error", "Failed to initialize platform");
         return false;
     }
 
     // Get screen bounds
-    Desktop desktop = mPlatform->getDesktop();
-    mScreenBounds = Rect(
-        mConfig.screenX,
-        mConfig.screenY,
-        mConfig.screenWidth > 0 ? mConfig.screenWidth : desktop.width,
-        mConfig.screenHeight > 0 ? mConfig.screenHeight : desktop.height);
+    timeStartupStep("display", [this]() {
+        Desktop desktop = mPlatform->getDesktop();
+        mScreenBounds = Rect(
+            mConfig.screenX,
+            mConfig.screenY,
+            mConfig.screenWidth > 0 ? mConfig.screenWidth : desktop.width,
+            mConfig.screenHeight > 0 ? mConfig.screenHeight : desktop.height);
 
-    mDisplayId = generateDisplayId();
+        mDisplayId = generateDisplayId();
+    });
 
     log("log", "Screen bounds: " + std::to_string(mScreenBounds.width) + "x" + std::to_string(mScreenBounds.height));
 
@@ -617,12 +817,16 @@ bool Konflikt::init()
         onClientConnected(conn);
     }, .onDisconnect = [this](void *conn) {
         onClientDisconnected(conn);
-    }, .onMessage = [this](const std::string &msg, void *conn) {
+    }, .onMessage = [this](std::string_view msg, void *conn) {
         onWebSocketMessage(msg, conn);
     } });
 
-    // Create HTTP server (same port as WebSocket for now)
-    mHttpServer = std::make_unique<HttpServer>(mConfig.port);
+    // HTTP routes are served from the WebSocket server's app, on the same port and loop
+    mHttpServer = std::make_unique<HttpServer>();
+    mWsServer->setHttpServer(mHttpServer.get());
+    ThreadOptions networkThread = mConfig.networkThread;
+    networkThread.name = "konflikt-net";
+    mWsServer->setThreadOptions(std::move(networkThread));
 
     // Serve static UI files if path is configured
     if (!mConfig.uiPath.empty() && std::filesystem::exists(mConfig.uiPath)) {
@@ -654,7 +858,7 @@ bool Konflikt::init()
         HttpResponse response;
         response.contentType = "application/json";
 
-        uint64_t uptime = (mStartTime > 0) ? (timestamp() - mStartTime) : 0;
+        uint64_t uptime = (mStartTime > 0) ? (monotonicNs() - mStartTime) / NS_PER_MS : 0;
         HealthJson health { "ok", std::string(VERSION), uptime };
 
         auto json = glz::write_json(health);
@@ -736,7 +940,32 @@ bool Konflikt::init()
             status.clientCount = static_cast<int>(mWsServer->clientCount());
             status.tls = mConfig.useTLS;
             status.port = mWsServer->port();
-            status.activeClient = mActivatedClientId;
+            status.activeClient = mInstances.id(mActivatedClient);
+
+            std::unordered_map<std::string, LinkQualityJson> links;
+            {
+                auto now = LinkQuality::Clock::now();
+                std::lock_guard<std::mutex> lock(mLinksMutex);
+                for (const auto &[connection, handle] : mConnectionToInstance) {
+                    auto it = mLinks.find(connection);
+                    if (it == mLinks.end()) {
+                        continue;
+                    }
+                    const LinkQuality &link = it->second;
+                    LinkQualityJson lq;
+                    lq.rttMs = link.rttMs();
+                    lq.lastRttMs = link.lastRttMs();
+                    lq.jitterMs = link.jitterMs();
+                    lq.heartbeatsSent = link.heartbeatsSent();
+                    lq.heartbeatsAcked = link.heartbeatsAcked();
+                    lq.heartbeatsLost = link.heartbeatsLost();
+                    lq.stalls = link.stalls();
+                    lq.maxStallMs = link.maxStallMs();
+                    lq.silenceMs = link.silenceMs(now);
+                    lq.degraded = link.isDegraded(now);
+                    links[mInstances.id(handle)] = lq;
+                }
+            }
 
             std::vector<ClientInfoJson> clientList;
             for (const auto &[id, client] : mConnectedClients) {
@@ -747,6 +976,11 @@ bool Konflikt::init()
                 ci.screenHeight = client.screenHeight;
                 ci.connectedAt = client.connectedAt;
                 ci.active = client.active;
+                ci.online = client.disconnectedAt == 0;
+                auto link = links.find(client.instanceId);
+                if (link != links.end()) {
+                    ci.link = link->second;
+                }
                 clientList.push_back(ci);
             }
             status.clients = clientList;
@@ -756,6 +990,14 @@ bool Konflikt::init()
             status.connectedServer = mConnectedServerName;
         }
 
+        {
+            std::lock_guard<std::mutex> lock(mStartupMutex);
+            status.startup.readyMs = mStartupReadyMs;
+            for (const StartupStep &step : mStartupSteps) {
+                status.startup.steps.push_back({ step.name, step.startMs, step.durationMs });
+            }
+        }
+
         auto json = glz::write_json(status);
         if (json) {
             if (req.path.find("pretty") != std::string::npos) {
@@ -774,13 +1016,37 @@ bool Konflikt::init()
         HttpResponse response;
         response.contentType = "application/json";
 
-        DiscoveredServersJson result;
+        std::vector<DiscoveredService> discovered;
         if (mServiceDiscovery) {
-            for (const auto &service : mServiceDiscovery->getDiscoveredServices()) {
-                result.servers.push_back({ service.name,
-                                           service.host,
-                                           service.port,
-                                           service.instanceId });
+            discovered = mServiceDiscovery->getDiscoveredServices();
+        }
+        std::vector<CachedServer> cached;
+        {
+            std::lock_guard<std::mutex> lock(mServerCacheMutex);
+            cached = mServerCache.ranked();
+        }
+
+        DiscoveredServersJson result;
+        for (const CachedServer &server : cached) {
+            bool online = std::any_of(discovered.begin(), discovered.end(), [&](const DiscoveredService &service) {
+                return service.host == server.host && service.port == server.port;
+            });
+            result.servers.push_back({ server.name,
+                                       server.host,
+                                       server.port,
+                                       server.instanceId,
+                                       online,
+                                       server.lastSeen,
+                                       server.lastConnected,
+                                       server.rttMs,
+                                       server.failures });
+        }
+        for (const auto &service : discovered) {
+            bool known = std::any_of(cached.begin(), cached.end(), [&](const CachedServer &server) {
+                return service.host == server.host && service.port == server.port;
+            });
+            if (!known) {
+                result.servers.push_back({ service.name, service.host, service.port, service.instanceId, true });
             }
         }
 
@@ -920,11 +1186,12 @@ bool Konflikt::init()
         }
 
         // Get or create entry for this display
+        bool isNew = mConfig.displayEdges.find(update.displayId) == mConfig.displayEdges.end();
         auto &edges = mConfig.displayEdges[update.displayId];
         bool changed = false;
 
         // Initialize with global defaults if this is a new entry
-        if (mConfig.displayEdges.find(update.displayId) == mConfig.displayEdges.end()) {
+        if (isNew) {
             edges.left = mConfig.edgeLeft;
             edges.right = mConfig.edgeRight;
             edges.top = mConfig.edgeTop;
@@ -949,6 +1216,7 @@ bool Konflikt::init()
         }
 
         if (changed) {
+            rebuildEdges();
             response.body = "{\"success\":true,\"message\":\"Display edge settings updated\"}";
             log("log", "Display edge settings updated for display " + std::to_string(update.displayId) + " via API");
         } else {
@@ -975,6 +1243,7 @@ bool Konflikt::init()
         auto it = mConfig.displayEdges.find(delReq.displayId);
         if (it != mConfig.displayEdges.end()) {
             mConfig.displayEdges.erase(it);
+            rebuildEdges();
             response.body = "{\"success\":true,\"message\":\"Display edge settings removed, using global defaults\"}";
             log("log", "Display edge settings removed for display " + std::to_string(delReq.displayId));
         } else {
@@ -1001,13 +1270,23 @@ bool Konflikt::init()
         if (mWsClient) {
             status.serverHost = mWsClient->host();
             status.serverPort = mWsClient->port();
+            WebSocketConnectStats connectStats = mWsClient->lastConnectStats();
+            status.connectMs = connectStats.connectMs;
+            status.tls = connectStats.tls;
+            status.tlsResumed = connectStats.tlsResumed;
+            status.tlsCipher = connectStats.tlsCipher;
         } else {
             status.serverHost = mConfig.serverHost;
             status.serverPort = mConfig.serverPort;
         }
         status.serverName = mConnectedServerName;
-        status.reconnectAttempts = mReconnectAttempts;
-        status.maxReconnectAttempts = MAX_RECONNECT_ATTEMPTS;
+        {
+            std::lock_guard<std::mutex> lock(mReconnectMutex);
+            uint64_t now = monotonicNs();
+            status.reconnectAttempts = static_cast<int>(mReconnectBackoff.attempts());
+            status.nextReconnectMs = mNextReconnectAt == 0 ? -1
+                : static_cast<int64_t>(mNextReconnectAt > now ? (mNextReconnectAt - now) / NS_PER_MS : 0);
+        }
         status.expectingReconnect = mExpectingReconnect;
 
         auto json = glz::write_json(status);
@@ -1041,8 +1320,8 @@ bool Konflikt::init()
         }
 
         // Reset reconnection state and trigger immediate reconnect
-        mReconnectAttempts = 0;
-        mLastReconnectAttempt = 0;
+        mAutoReconnect = true;
+        resetReconnect();
         updateStatus(ConnectionStatus::Connecting, "Reconnecting...");
         mWsClient->reconnect();
 
@@ -1088,7 +1367,8 @@ bool Konflikt::init()
         // Update config and connect
         mConfig.serverHost = host;
         mConfig.serverPort = port;
-        mReconnectAttempts = 0;
+        mAutoReconnect = true;
+        resetReconnect();
         updateStatus(ConnectionStatus::Connecting, "Connecting to " + host + "...");
         mWsClient->connect(host, port, "/ws");
 
@@ -1115,7 +1395,7 @@ bool Konflikt::init()
         }
 
         // Disable reconnection and disconnect
-        mReconnectAttempts = MAX_RECONNECT_ATTEMPTS; // Prevent auto-reconnect
+        mAutoReconnect = false;
         mWsClient->disconnect();
         updateStatus(ConnectionStatus::Disconnected, "Disconnected by user");
 
@@ -1167,6 +1447,10 @@ bool Konflikt::init()
         config.lockCursorHotkey = mConfig.lockCursorHotkey;
         config.verbose = mConfig.verbose;
         config.logKeycodes = mConfig.logKeycodes;
+        config.pointerSpeed = mConfig.pointerSpeed;
+        config.pointerAcceleration = mConfig.pointerAcceleration;
+        config.pointerAccelerationThreshold = mConfig.pointerAccelerationThreshold;
+        config.jitterBufferMs = mConfig.jitterBufferMs;
 
         for (const auto &[from, to] : mConfig.keyRemap) {
             config.keyRemap[std::to_string(from)] = to;
@@ -1229,8 +1513,22 @@ bool Konflikt::init()
             mConfig.logKeycodes = *update.logKeycodes;
             changed = true;
         }
+        if (update.pointerSpeed.has_value() && *update.pointerSpeed > 0) {
+            mConfig.pointerSpeed = *update.pointerSpeed;
+            changed = true;
+        }
+        if (update.pointerAcceleration.has_value() && *update.pointerAcceleration >= 0) {
+            mConfig.pointerAcceleration = *update.pointerAcceleration;
+            changed = true;
+        }
+        if (update.pointerAccelerationThreshold.has_value() && *update.pointerAccelerationThreshold >= 0) {
+            mConfig.pointerAccelerationThreshold = *update.pointerAccelerationThreshold;
+            changed = true;
+        }
 
         if (changed) {
+            rebuildEdges();
+            rebuildPointerCurve();
             response.body = "{\"success\":true,\"message\":\"Config updated\"}";
             log("log", "Config updated via API");
         } else {
@@ -1261,18 +1559,47 @@ bool Konflikt::init()
         HttpResponse response;
         response.contentType = "application/json";
 
+        InputStats inputStats;
+        {
+            std::lock_guard<std::mutex> lock(mInputStatsMutex);
+            inputStats = mInputStats;
+        }
         StatsJson stats {
-            mInputStats.totalEvents,
-            mInputStats.mouseEvents,
-            mInputStats.keyEvents,
-            mInputStats.scrollEvents,
-            mInputStats.eventsPerSecond,
-            { mInputStats.lastLatencyMs,
-              mInputStats.avgLatencyMs,
-              mInputStats.maxLatencyMs,
-              mInputStats.latencySamples }
+            inputStats.totalEvents,
+            inputStats.mouseEvents,
+            inputStats.keyEvents,
+            inputStats.scrollEvents,
+            inputStats.eventsPerSecond,
+            { inputStats.lastLatencyMs,
+              inputStats.avgLatencyMs,
+              inputStats.maxLatencyMs,
+              inputStats.latencySamples },
+            {}
         };
 
+        for (const ThreadSchedStats &thread : threadSchedStats()) {
+            ThreadSchedStats delta = thread;
+            auto baseline = mThreadStatsBaseline.find(thread.name);
+            if (baseline != mThreadStatsBaseline.end() && baseline->second.timeslices <= thread.timeslices) {
+                delta.runNs -= baseline->second.runNs;
+                delta.waitNs -= baseline->second.waitNs;
+                delta.timeslices -= baseline->second.timeslices;
+            }
+
+            ThreadStatsJson json;
+            json.name = thread.name;
+            json.policy = threadPolicyName(thread.options.policy);
+            json.priority = thread.options.priority;
+            json.nice = thread.options.nice;
+            json.cpus = thread.options.cpus;
+            json.runMs = static_cast<double>(delta.runNs) / 1e6;
+            json.waitMs = static_cast<double>(delta.waitNs) / 1e6;
+            json.timeslices = delta.timeslices;
+            json.avgWaitUs = delta.timeslices ? static_cast<double>(delta.waitNs) / 1e3 / static_cast<double>(delta.timeslices) : 0.0;
+            json.error = thread.error;
+            stats.threads.push_back(std::move(json));
+        }
+
         auto json = glz::write_json(stats);
         if (json) {
             // Check if pretty printing requested via query param ?pretty
@@ -1292,7 +1619,14 @@ bool Konflikt::init()
         HttpResponse response;
         response.contentType = "application/json";
 
-        mInputStats = InputStats {};
+        {
+            std::lock_guard<std::mutex> lock(mInputStatsMutex);
+            mInputStats = InputStats {};
+        }
+        mThreadStatsBaseline.clear();
+        for (ThreadSchedStats &thread : threadSchedStats()) {
+            mThreadStatsBaseline[thread.name] = std::move(thread);
+        }
         response.body = "{\"success\":true,\"message\":\"Statistics reset\"}";
         log("log", "Statistics reset via API");
 
@@ -1339,24 +1673,17 @@ bool Konflikt::init()
         // Check for preset
         if (request.preset.has_value()) {
             const std::string &preset = *request.preset;
-            if (preset == "mac-to-linux") {
-                mConfig.keyRemap[55] = 133;   // Command Left -> Super Left
-                mConfig.keyRemap[54] = 134;   // Command Right -> Super Right
-                mConfig.keyRemap[58] = 64;    // Option Left -> Alt Left
-                mConfig.keyRemap[61] = 108;   // Option Right -> Alt Right
-                response.body = "{\"success\":true,\"message\":\"Applied mac-to-linux preset\"}";
-                log("log", "Applied mac-to-linux key remap preset via API");
-                return response;
-            } else if (preset == "linux-to-mac") {
-                mConfig.keyRemap[133] = 55;   // Super Left -> Command Left
-                mConfig.keyRemap[134] = 54;   // Super Right -> Command Right
-                mConfig.keyRemap[64] = 58;    // Alt Left -> Option Left
-                mConfig.keyRemap[108] = 61;   // Alt Right -> Option Right
-                response.body = "{\"success\":true,\"message\":\"Applied linux-to-mac preset\"}";
-                log("log", "Applied linux-to-mac key remap preset via API");
+            if (auto entries = keyRemapPreset(preset); !entries.empty()) {
+                for (const auto &entry : entries) {
+                    mConfig.keyRemap[entry.from] = entry.to;
+                }
+                rebuildKeyRemap();
+                response.body = "{\"success\":true,\"message\":\"Applied " + preset + " preset\"}";
+                log("log", "Applied " + preset + " key remap preset via API");
                 return response;
             } else if (preset == "clear") {
                 mConfig.keyRemap.clear();
+                rebuildKeyRemap();
                 response.body = "{\"success\":true,\"message\":\"Cleared all key remaps\"}";
                 log("log", "Cleared key remaps via API");
                 return response;
@@ -1373,6 +1700,7 @@ bool Konflikt::init()
             uint32_t fromKey = static_cast<uint32_t>(*request.from);
             uint32_t toKey = static_cast<uint32_t>(*request.to);
             mConfig.keyRemap[fromKey] = toKey;
+            rebuildKeyRemap();
             response.body = "{\"success\":true,\"message\":\"Added key remap " +
                 std::to_string(fromKey) + " -> " + std::to_string(toKey) + "\"}";
             log("log", "Added key remap " + std::to_string(fromKey) + " -> " + std::to_string(toKey) + " via API");
@@ -1403,6 +1731,7 @@ bool Konflikt::init()
         auto it = mConfig.keyRemap.find(fromKey);
         if (it != mConfig.keyRemap.end()) {
             mConfig.keyRemap.erase(it);
+            rebuildKeyRemap();
             response.body = "{\"success\":true,\"message\":\"Removed key remap for " +
                 std::to_string(fromKey) + "\"}";
             log("log", "Removed key remap for " + std::to_string(fromKey) + " via API");
@@ -1416,21 +1745,51 @@ bool Konflikt::init()
 
     // Set up platform event handler for server role
     if (mConfig.role == InstanceRole::Server) {
-        mLayoutManager = std::make_unique<LayoutManager>();
+        mOwnHandle = mInstances.intern(mConfig.instanceId);
+        mLayoutManager = std::make_unique<LayoutManager>(mInstances);
         mLayoutManager->setServerScreen(
-            mConfig.instanceId,
+            mOwnHandle,
             mConfig.instanceName,
             mMachineId,
             mScreenBounds.width,
             mScreenBounds.height);
 
+        if (!mConfig.traceRecordFile.empty()) {
+            mTraceWriter = std::make_unique<InputTraceWriter>();
+            if (mTraceWriter->open(mConfig.traceRecordFile)) {
+                log("log", "Recording input trace to " + mConfig.traceRecordFile);
+            } else {
+                log("error", "Failed to open input trace file: " + mConfig.traceRecordFile);
+                mTraceWriter.reset();
+            }
+        }
+
         mPlatform->onEvent = [this](const Event &event) {
+            if (mTraceWriter) {
+                mTraceWriter->append(event);
+            }
             onPlatformEvent(event);
         };
 
-        mPlatform->startListening();
+        ThreadOptions captureThread = mConfig.captureThread;
+        captureThread.name = "konflikt-input";
+        mPlatform->setListenerThreadOptions(captureThread);
+        if (mConfig.traceReplayFile.empty()) {
+            mPlatform->startListening();
+        } else {
+            // The trace is the input; live capture would race it on the same state
+            log("log", "Input capture disabled while replaying " + mConfig.traceReplayFile);
+        }
         mIsActiveInstance = true;
     } else {
+        if (mConfig.jitterBufferMs > 0) {
+            auto target = std::chrono::microseconds(static_cast<int64_t>(mConfig.jitterBufferMs * 1000));
+            mJitterBuffer = std::make_unique<MotionJitterBuffer>(target, [this](const Event &event) {
+                injectMouseMove(event);
+            });
+            log("log", "Motion jitter buffer enabled (" + std::to_string(target.count()) + " us)");
+        }
+
         // Client role: create WebSocket client
         mWsClient = std::make_unique<WebSocketClient>();
 
@@ -1443,9 +1802,26 @@ bool Konflikt::init()
             log("log", "TLS enabled for WebSocket client");
         }
 
+        ThreadOptions clientThread = mConfig.clientThread;
+        clientThread.name = "konflikt-client";
+        mWsClient->setThreadOptions(std::move(clientThread));
+
         mWsClient->setCallbacks({ .onConnect = [this]() {
+            {
+                std::lock_guard<std::mutex> lock(mLinksMutex);
+                mLastServerMessage = LinkQuality::Clock::now();
+                mServerSendsHeartbeats = false;  // Until the handshake response says so
+            }
             updateStatus(ConnectionStatus::Connected, "Connected to server");
-            mReconnectAttempts = 0;       // Reset on successful connection
+            if (std::string error = mWsClient->threadOptionsError(); !error.empty()) {
+                log("error", "Client thread options: " + error);
+            }
+            if (WebSocketConnectStats stats = mWsClient->lastConnectStats(); stats.tls) {
+                log("verbose", "TLS " + stats.tlsVersion + " " + stats.tlsCipher +
+                    (stats.tlsResumed ? " (resumed)" : " (full handshake)") + " in " +
+                    std::to_string(static_cast<int>(stats.connectMs)) + "ms");
+            }
+            resetReconnect();             // Reset on successful connection
             mExpectingReconnect = false;  // Clear graceful shutdown flag
             mExpectedRestartDelayMs = 0;
                 // Send handshake
@@ -1453,54 +1829,121 @@ bool Konflikt::init()
             req.instanceId = mConfig.instanceId;
             req.instanceName = mConfig.instanceName;
             req.version = VERSION;
-            req.capabilities = { "input_events", "screen_info" };
+            req.capabilities = advertisedCapabilities();
+            if (*KONFLIKT_GIT_COMMIT) {
+                req.gitCommit = KONFLIKT_GIT_COMMIT;
+            }
             req.timestamp = timestamp();
+            if (!mSessionToken.empty()) {
+                req.resumeToken = mSessionToken;
+            }
+            mHandshakeSentAt = LinkQuality::Clock::now();
             mWsClient->send(toJson(req));
         }, .onDisconnect = [this](const std::string &reason) {
+            releaseInjectedInput();
             updateStatus(ConnectionStatus::Disconnected, reason);
-            // Trigger reconnection attempt
-            mLastReconnectAttempt = 0; // Allow immediate first attempt
         }, .onMessage = [this](const std::string &msg) {
             onWebSocketMessage(msg, nullptr);
         }, .onError = [this](const std::string &err) {
             updateStatus(ConnectionStatus::Error, err);
         } });
+
+        // Only display changes are needed from the platform, to tell the server
+        mPlatform->onEvent = [this](const Event &event) {
+            if (event.type == EventType::DesktopChanged) {
+                onDesktopChanged();
+            }
+        };
+        mPlatform->startWatchingDesktop();
+    }
+
+    discovery.wait();
+    if (serverCache.valid()) {
+        serverCache.wait();
     }
+    return true;
+}
 
-    // Initialize service discovery
-    mServiceDiscovery = std::make_unique<ServiceDiscovery>();
-    mServiceDiscovery->setCallbacks({ .onServiceFound = [this](const DiscoveredService &service) {
-        onServiceFound(service);
+void Konflikt::initServiceDiscovery()
+{
+    auto serviceDiscovery = std::make_unique<ServiceDiscovery>();
+    // Events arrive on the discovery thread; handle them on the main loop
+    serviceDiscovery->setCallbacks({ .onServiceFound = [this](const DiscoveredService &service) {
+        post([this, service]() {
+            onServiceFound(service);
+        });
     }, .onServiceLost = [this](const std::string &name) {
-        onServiceLost(name);
+        post([this, name]() {
+            onServiceLost(name);
+        });
     }, .onError = [this](const std::string &error) {
         log("error", "Service discovery: " + error);
     } });
+    mServiceDiscovery = std::move(serviceDiscovery);
+}
 
-    return true;
+void Konflikt::timeStartupStep(const std::string &name, const std::function<void()> &step)
+{
+    auto start = std::chrono::steady_clock::now();
+    step();
+    auto end = std::chrono::steady_clock::now();
+
+    using Ms = std::chrono::duration<double, std::milli>;
+    std::lock_guard<std::mutex> lock(mStartupMutex);
+    mStartupSteps.push_back({ name, Ms(start - mStartupBegin).count(), Ms(end - start).count() });
+}
+
+void Konflikt::logStartupTimeline()
+{
+    std::string steps;
+    {
+        std::lock_guard<std::mutex> lock(mStartupMutex);
+        mStartupReadyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mStartupBegin).count();
+        std::sort(mStartupSteps.begin(), mStartupSteps.end(), [](const StartupStep &a, const StartupStep &b) {
+            return a.startMs < b.startMs;
+        });
+        for (const StartupStep &step : mStartupSteps) {
+            steps += (steps.empty() ? "" : ", ") + step.name + " " + std::to_string(static_cast<int>(step.durationMs)) +
+                "ms @" + std::to_string(static_cast<int>(step.startMs));
+        }
+        steps = "Ready in " + std::to_string(static_cast<int>(mStartupReadyMs)) + "ms (" + steps + ")";
+    }
+    log("log", steps);
 }
 
 void Konflikt::run()
 {
     mRunning = true;
-    mStartTime = timestamp();
+    mStartTime = monotonicNs();
 
     // Start servers
     if (mConfig.role == InstanceRole::Server) {
-        if (!mWsServer->start()) {
+        bool listening = false;
+        timeStartupStep("listen", [this, &listening]() {
+            listening = mWsServer->start();
+        });
+        if (!listening) {
             log("error", "Failed to start WebSocket server");
             return;
         }
-        if (!mHttpServer->start()) {
-            log("error", "Failed to start HTTP server");
-            return;
+        if (!mWsServer->threadOptionsError().empty()) {
+            log("error", "Network thread options: " + mWsServer->threadOptionsError());
         }
         log("log", "Server listening on port " + std::to_string(mWsServer->port()));
         updateStatus(ConnectionStatus::Connected, "Server running");
 
         // Register service for discovery
-        if (mServiceDiscovery->registerService(mConfig.instanceName, mWsServer->port(), mConfig.instanceId)) {
-            log("log", "Registered mDNS service: " + mConfig.instanceName);
+        mAdvertisedClients = 0;
+        timeStartupStep("mdns register", [this]() {
+            if (mServiceDiscovery->registerService(mConfig.instanceName, mWsServer->port(), mConfig.instanceId, serviceInfo())) {
+                log("log", "Registered mDNS service: " + mConfig.instanceName);
+            }
+        });
+
+        if (!mConfig.traceReplayFile.empty()) {
+            mReplayThread = std::thread([this]() {
+                replayTrace(mConfig.traceReplayFile, mConfig.traceReplaySpeed);
+            });
         }
     } else {
         // Client: connect to server
@@ -1509,57 +1952,115 @@ void Konflikt::run()
             updateStatus(ConnectionStatus::Connecting, "Connecting...");
             mWsClient->connect(mConfig.serverHost, mConfig.serverPort, "/ws");
         } else {
-            // No server specified, browse for servers
+            // No server specified: connect to the best known one right away and
+            // keep browsing, so startup doesn't wait for mDNS (the cache was
+            // loaded during init)
+            std::optional<ServerEndpoint> best;
+            {
+                std::lock_guard<std::mutex> lock(mServerCacheMutex);
+                best = mServerCache.best();
+            }
+            if (best) {
+                log("log", "Connecting to cached server " + best->host + ":" + std::to_string(best->port));
+                updateStatus(ConnectionStatus::Connecting, "Connecting to " + best->host + "...");
+                mWsClient->connect(best->host, best->port, "/ws");
+            } else {
+                updateStatus(ConnectionStatus::Connecting, "Searching for servers...");
+            }
             log("log", "Browsing for Konflikt servers...");
-            updateStatus(ConnectionStatus::Connecting, "Searching for servers...");
-            mServiceDiscovery->startBrowsing();
+            timeStartupStep("mdns browse", [this]() {
+                mServiceDiscovery->startBrowsing();
+            });
+        }
+
+        // Retry as soon as the network comes back rather than waiting out the backoff
+        mNetworkMonitor = std::make_unique<NetworkMonitor>();
+        if (!mNetworkMonitor->start()) {
+            log("verbose", "Network change monitoring unavailable");
+            mNetworkMonitor.reset();
+        }
+    }
+
+    // Apply edits to the config file as they are saved
+    if (!mConfig.configPath.empty()) {
+        mConfigWatcher = std::make_unique<ConfigWatcher>();
+        if (mConfigWatcher->start(mConfig.configPath)) {
+            mFileConfig = ConfigManager::load(mConfig.configPath).value_or(Config {});
+        } else {
+            log("verbose", "Config file watching unavailable for " + mConfig.configPath);
+            mConfigWatcher.reset();
         }
     }
 
+    logStartupTimeline();
+
     // Main loop
     while (mRunning) {
+        runTasks();
+
         if (mWsClient) {
             mWsClient->poll();
 
             // Auto-reconnect for clients
-            if (mConfig.role == InstanceRole::Client &&
-                mConnectionStatus == ConnectionStatus::Disconnected &&
-                !mWsClient->host().empty() &&
-                mReconnectAttempts < MAX_RECONNECT_ATTEMPTS) {
-                uint64_t now = timestamp();
-                // Use shorter delay if server sent graceful shutdown, or use expected restart delay
-                uint64_t delay = RECONNECT_DELAY_MS;
-                if (mExpectingReconnect) {
-                    // If server told us when it expects to be back, use that + small buffer
-                    // Otherwise use a shorter delay for graceful restarts
-                    delay = mExpectedRestartDelayMs > 0
-                        ? static_cast<uint64_t>(mExpectedRestartDelayMs) + 500
-                        : 1000;
-                }
-
-                if (now - mLastReconnectAttempt >= delay) {
-                    mLastReconnectAttempt = now;
-                    mReconnectAttempts++;
-                    if (mExpectingReconnect) {
-                        log("log", "Reconnecting after graceful server shutdown (attempt " + std::to_string(mReconnectAttempts) + ")");
-                    } else {
-                        log("log", "Reconnection attempt " + std::to_string(mReconnectAttempts) + "/" + std::to_string(MAX_RECONNECT_ATTEMPTS));
-                    }
-                    updateStatus(ConnectionStatus::Connecting, "Reconnecting...");
-                    mWsClient->reconnect();
-                }
+            if (mConfig.role == InstanceRole::Client) {
+                checkReconnect();
             }
         }
 
-        // Poll service discovery for events
-        if (mServiceDiscovery) {
-            mServiceDiscovery->poll();
+        // Keep the advertised load current so clients can skip a full server
+        if (mServiceDiscovery && mWsServer && mAdvertisedClients >= 0 &&
+            static_cast<int>(mWsServer->clientCount()) != mAdvertisedClients) {
+            ServiceInfo info = serviceInfo();
+            mAdvertisedClients = info.clients;
+            mServiceDiscovery->updateServiceInfo(info);
         }
 
+        checkConfigFile();
+
         // Check for clipboard changes periodically
         checkClipboardChange();
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        // Send input coalesced since the last tick
+        if (mConfig.role == InstanceRole::Server && mHasVirtualCursor) {
+            flushPendingInput();
+        }
+
+        // Exchange heartbeats (held-input digests and link probes) with clients
+        if (mConfig.role == InstanceRole::Server && monotonicNs() - mLastHeartbeat >= HEARTBEAT_INTERVAL_MS * NS_PER_MS) {
+            mLastHeartbeat = monotonicNs();
+            sendHeartbeat();
+            mWsServer->post([this]() {
+                expireSessions();
+            });
+        }
+        checkLinks();
+
+        // Tick every 10ms, or sooner when a task is posted
+        std::unique_lock<std::mutex> lock(mTasksMutex);
+        mTasksCondition.wait_for(lock, std::chrono::milliseconds(10), [this]() {
+            return !mTasks.empty();
+        });
+    }
+}
+
+void Konflikt::post(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mTasksMutex);
+        mTasks.push_back(std::move(task));
+    }
+    mTasksCondition.notify_one();
+}
+
+void Konflikt::runTasks()
+{
+    std::vector<std::function<void()>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(mTasksMutex);
+        tasks.swap(mTasks);
+    }
+    for (std::function<void()> &task : tasks) {
+        task();
     }
 }
 
@@ -1567,21 +2068,33 @@ void Konflikt::stop()
 {
     mRunning = false;
 
+    if (mReplayThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mReplayMutex);
+        }
+        mReplayCondition.notify_all();
+        mReplayThread.join();
+    }
+
     if (mPlatform) {
         mPlatform->stopListening();
         mPlatform->shutdown();
     }
 
-    if (mWsServer) {
-        mWsServer->stop();
+    if (mTraceWriter) {
+        log("log", "Input trace closed (" + std::to_string(mTraceWriter->recordCount()) + " events)");
+        mTraceWriter.reset();
     }
 
-    if (mHttpServer) {
-        mHttpServer->stop();
+    if (mWsServer) {
+        mWsServer->stop();
     }
 
     if (mWsClient) {
         mWsClient->disconnect();
+        if (mConfig.serverHost.empty()) {
+            saveServerCache();  // Keep last-seen times of servers we never connected to
+        }
     }
 }
 
@@ -1590,9 +2103,46 @@ void Konflikt::quit()
     mRunning = false;
 }
 
+bool Konflikt::replayTrace(const std::string &path, double speed)
+{
+    InputTraceReader reader;
+    if (!reader.open(path)) {
+        log("error", "Failed to open input trace: " + path);
+        return false;
+    }
+
+    log("log", "Replaying " + std::to_string(reader.size()) + " events from " + path);
+
+    auto start = std::chrono::steady_clock::now();
+    size_t replayed = 0;
+    for (size_t i = 0; i < reader.size() && mRunning; ++i) {
+        if (speed > 0) {
+            auto offset = std::chrono::nanoseconds(
+                static_cast<int64_t>(static_cast<double>(reader.record(i).offsetNs) / speed));
+            std::unique_lock<std::mutex> lock(mReplayMutex);
+            if (mReplayCondition.wait_until(lock, start + offset, [this]() { return !mRunning; })) {
+                break;
+            }
+        }
+        // Restamp so delivery latency downstream reflects this run, not the recording.
+        // Handled on the main loop, like any other task, so only one thread touches input state
+        Event event = reader.event(i);
+        event.timestamp = timestamp();
+        post([this, event]() {
+            onPlatformEvent(event);
+        });
+        ++replayed;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    log("log", "Trace replay finished: " + std::to_string(replayed) + " events in " + std::to_string(elapsed.count()) + "ms");
+    return true;
+}
+
 int Konflikt::httpPort() const
 {
-    return mHttpServer ? mHttpServer->port() : mConfig.port;
+    return mWsServer ? mWsServer->port() : mConfig.port;
 }
 
 std::vector<std::string> Konflikt::connectedClientNames() const
@@ -1604,17 +2154,44 @@ std::vector<std::string> Konflikt::connectedClientNames() const
     return names;
 }
 
-uint32_t Konflikt::remapKeycode(uint32_t keycode) const
+void Konflikt::rebuildKeyRemap()
 {
-    auto it = mConfig.keyRemap.find(keycode);
-    if (it != mConfig.keyRemap.end()) {
-        return it->second;
-    }
-    return keycode;
+    mKeyRemap.publish(std::make_shared<const KeyRemapTable>(mConfig.keyRemap));
+}
+
+void Konflikt::rebuildPointerCurve()
+{
+    mPointerCurve.publish(std::make_shared<const PointerCurve>(
+        PointerCurve { mConfig.pointerSpeed, mConfig.pointerAcceleration, mConfig.pointerAccelerationThreshold }));
+}
+
+void Konflikt::rebuildEdges()
+{
+    auto table = std::make_shared<EdgeTable>();
+    table->global.left = mConfig.edgeLeft;
+    table->global.right = mConfig.edgeRight;
+    table->global.top = mConfig.edgeTop;
+    table->global.bottom = mConfig.edgeBottom;
+    table->displays = mConfig.displayEdges;
+    mEdges.publish(std::move(table));
+}
+
+Rect Konflikt::screenBounds() const
+{
+    std::lock_guard<std::mutex> lock(mCursorMutex);
+    return mScreenBounds;
+}
+
+Konflikt::VirtualCursor Konflikt::virtualCursor() const
+{
+    std::lock_guard<std::mutex> lock(mCursorMutex);
+    return mVirtualCursor;
 }
 
 Config::DisplayEdges Konflikt::getEdgeSettingsForPoint(int32_t x, int32_t y) const
 {
+    const EdgeTable &table = mEdges.read();
+
     // Find which display contains this point
     if (mPlatform) {
         Desktop desktop = mPlatform->getDesktop();
@@ -1622,8 +2199,8 @@ Config::DisplayEdges Konflikt::getEdgeSettingsForPoint(int32_t x, int32_t y) con
             if (x >= display.x && x < display.x + display.width &&
                 y >= display.y && y < display.y + display.height) {
                 // Check if we have per-display settings for this display
-                auto it = mConfig.displayEdges.find(display.id);
-                if (it != mConfig.displayEdges.end()) {
+                auto it = table.displays.find(display.id);
+                if (it != table.displays.end()) {
                     return it->second;
                 }
                 break;
@@ -1632,16 +2209,14 @@ Config::DisplayEdges Konflikt::getEdgeSettingsForPoint(int32_t x, int32_t y) con
     }
 
     // Fall back to global edge settings
-    Config::DisplayEdges edges;
-    edges.left = mConfig.edgeLeft;
-    edges.right = mConfig.edgeRight;
-    edges.top = mConfig.edgeTop;
-    edges.bottom = mConfig.edgeBottom;
-    return edges;
+    return table.global;
 }
 
-void Konflikt::updateInputStats(const std::string &eventType)
+void Konflikt::updateInputStats(std::string_view eventType)
 {
+    uint64_t now = monotonicNs();
+
+    std::lock_guard<std::mutex> lock(mInputStatsMutex);
     mInputStats.totalEvents++;
 
     if (eventType == "mouseMove" || eventType == "mousePress" || eventType == "mouseRelease") {
@@ -1653,7 +2228,6 @@ void Konflikt::updateInputStats(const std::string &eventType)
     }
 
     // Calculate events per second over a 1-second window
-    uint64_t now = timestamp();
     if (mInputStats.windowStartTime == 0) {
         mInputStats.windowStartTime = now;
     }
@@ -1661,8 +2235,8 @@ void Konflikt::updateInputStats(const std::string &eventType)
     mInputStats.eventsInWindow++;
 
     uint64_t elapsed = now - mInputStats.windowStartTime;
-    if (elapsed >= 1000) {
-        mInputStats.eventsPerSecond = static_cast<double>(mInputStats.eventsInWindow) * 1000.0 / static_cast<double>(elapsed);
+    if (elapsed >= 1000 * NS_PER_MS) {
+        mInputStats.eventsPerSecond = static_cast<double>(mInputStats.eventsInWindow) * 1e9 / static_cast<double>(elapsed);
         mInputStats.windowStartTime = now;
         mInputStats.eventsInWindow = 0;
     }
@@ -1674,12 +2248,15 @@ void Konflikt::recordLatency(uint64_t eventTimestamp)
         return;
     }
 
+    // The event was stamped on the sending machine, whose monotonicNs() epoch
+    // differs from ours, so only wall-clock time compares (at ms resolution)
     uint64_t now = timestamp();
     if (now < eventTimestamp) {
         return; // Clock skew, ignore
     }
 
     double latency = static_cast<double>(now - eventTimestamp);
+    std::lock_guard<std::mutex> lock(mInputStatsMutex);
     mInputStats.lastLatencyMs = latency;
     mInputStats.latencySamples++;
     mInputStats.latencySum += latency;
@@ -1695,24 +2272,31 @@ void Konflikt::onPlatformEvent(const Event &event)
     switch (event.type) {
         case EventType::MouseMove: {
             // Update local cursor position
-            if (mHasVirtualCursor && mActivatedClientId.empty() == false) {
+            if (mHasVirtualCursor && mActivatedClient != NO_INSTANCE) {
                 // Update virtual cursor
-                int32_t newX = mVirtualCursor.x + event.state.dx;
-                int32_t newY = mVirtualCursor.y + event.state.dy;
-
-                mVirtualCursor.x = std::clamp(newX, 0, mActiveRemoteScreenBounds.width - 1);
-                mVirtualCursor.y = std::clamp(newY, 0, mActiveRemoteScreenBounds.height - 1);
+                int32_t dx = event.state.dx;
+                int32_t dy = event.state.dy;
+                mPointerAccelerator.apply(mPointerCurve.read(), dx, dy);
 
                 InputEventData data;
-                data.x = mVirtualCursor.x;
-                data.y = mVirtualCursor.y;
-                data.dx = event.state.dx;
-                data.dy = event.state.dy;
+                {
+                    std::lock_guard<std::mutex> lock(mCursorMutex);
+                    mVirtualCursor.x = std::clamp(mVirtualCursor.x + dx, 0, mActiveRemoteScreenBounds.width - 1);
+                    mVirtualCursor.y = std::clamp(mVirtualCursor.y + dy, 0, mActiveRemoteScreenBounds.height - 1);
+                    data.x = mVirtualCursor.x;
+                    data.y = mVirtualCursor.y;
+                }
+                data.dx = dx;
+                data.dy = dy;
                 data.timestamp = event.timestamp;
                 data.keyboardModifiers = event.state.keyboardModifiers;
                 data.mouseButtons = event.state.mouseButtons;
 
-                broadcastInputEvent("mouseMove", data);
+                if (mCoalesceMotion) {
+                    queueMotion(data);
+                } else {
+                    broadcastInputEvent("mouseMove", data);
+                }
             } else {
                 // Check for screen transition
                 if (checkScreenTransition(event.state.x, event.state.y)) {
@@ -1725,9 +2309,10 @@ void Konflikt::onPlatformEvent(const Event &event)
         case EventType::MousePress:
         case EventType::MouseRelease: {
             if (mHasVirtualCursor) {
+                VirtualCursor cursor = virtualCursor();
                 InputEventData data;
-                data.x = mVirtualCursor.x;
-                data.y = mVirtualCursor.y;
+                data.x = cursor.x;
+                data.y = cursor.y;
                 data.timestamp = event.timestamp;
                 data.keyboardModifiers = event.state.keyboardModifiers;
                 data.mouseButtons = event.state.mouseButtons;
@@ -1739,6 +2324,17 @@ void Konflikt::onPlatformEvent(const Event &event)
                 else if (event.button == MouseButton::Middle)
                     data.button = "middle";
 
+                std::lock_guard<std::mutex> forward(mForwardMutex);
+                {
+                    std::lock_guard<std::mutex> lock(mPressedStateMutex);
+                    if (event.type == EventType::MousePress)
+                        mForwardedState.pressButton(toUInt32(event.button));
+                    else
+                        mForwardedState.releaseButton(toUInt32(event.button));
+                }
+
+                // Keep pending motion and scroll ordered before the click
+                flushPendingInput(true);
                 broadcastInputEvent(event.type == EventType::MousePress ? "mousePress" : "mouseRelease", data);
             }
             break;
@@ -1752,22 +2348,35 @@ void Konflikt::onPlatformEvent(const Event &event)
             }
 
             // Check for hotkey (only on key press)
-            if (event.type == EventType::KeyPress && mConfig.lockCursorHotkey != 0 &&
-                event.keycode == mConfig.lockCursorHotkey) {
+            uint32_t lockHotkey = mLockCursorHotkey.load(std::memory_order_relaxed);
+            if (event.type == EventType::KeyPress && lockHotkey != 0 && event.keycode == lockHotkey) {
                 // Toggle cursor lock
                 setLockCursorToScreen(!mConfig.lockCursorToScreen);
                 return; // Don't forward the hotkey
             }
 
             if (mHasVirtualCursor) {
+                VirtualCursor cursor = virtualCursor();
                 InputEventData data;
-                data.x = mVirtualCursor.x;
-                data.y = mVirtualCursor.y;
+                data.x = cursor.x;
+                data.y = cursor.y;
                 data.timestamp = event.timestamp;
                 data.keyboardModifiers = event.state.keyboardModifiers;
                 data.keycode = remapKeycode(event.keycode);
+                // A user remap overrides the canonical key, so the client must use the keycode
+                data.usage = data.keycode == event.keycode ? event.hidUsage : 0;
                 data.text = event.text;
 
+                std::lock_guard<std::mutex> forward(mForwardMutex);
+                {
+                    std::lock_guard<std::mutex> lock(mPressedStateMutex);
+                    if (event.type == EventType::KeyPress)
+                        mForwardedState.pressKey(data.keycode);
+                    else
+                        mForwardedState.releaseKey(data.keycode);
+                }
+
+                flushPendingInput(true);
                 broadcastInputEvent(event.type == EventType::KeyPress ? "keyPress" : "keyRelease", data);
             }
             break;
@@ -1775,27 +2384,74 @@ void Konflikt::onPlatformEvent(const Event &event)
 
         case EventType::MouseScroll: {
             if (mHasVirtualCursor) {
-                InputEventData data;
-                data.x = mVirtualCursor.x;
-                data.y = mVirtualCursor.y;
-                data.scrollX = event.state.scrollX;
-                data.scrollY = event.state.scrollY;
-                data.timestamp = event.timestamp;
-                data.keyboardModifiers = event.state.keyboardModifiers;
-
-                broadcastInputEvent("scroll", data);
+                queueScroll(event);
             }
             break;
         }
 
         case EventType::DesktopChanged:
-            // Handle desktop change if needed
+            onDesktopChanged();
             break;
     }
 }
 
-void Konflikt::onWebSocketMessage(const std::string &message, void *connection)
+void Konflikt::onDesktopChanged()
+{
+    // Listener thread, like the rest of onPlatformEvent
+    Desktop desktop = mPlatform->getDesktop();
+    int32_t width = mConfig.screenWidth > 0 ? mConfig.screenWidth : desktop.width;
+    int32_t height = mConfig.screenHeight > 0 ? mConfig.screenHeight : desktop.height;
+
+    log("verbose", "Desktop changed: " + std::to_string(desktop.displays.size()) + " displays, " +
+                       std::to_string(desktop.width) + "x" + std::to_string(desktop.height));
+
+    {
+        std::lock_guard<std::mutex> lock(mCursorMutex);
+        if (width <= 0 || height <= 0 || (width == mScreenBounds.width && height == mScreenBounds.height)) {
+            return;
+        }
+        mScreenBounds.width = width;
+        mScreenBounds.height = height;
+    }
+    log("log", "Screen bounds: " + std::to_string(width) + "x" + std::to_string(height));
+
+    if (mConfig.role == InstanceRole::Client) {
+        // If not connected, the next handshake carries the new size
+        if (mWsClient && mWsClient->isConnected()) {
+            sendScreenGeometry();
+        }
+        return;
+    }
+
+    if (!mLayoutManager) {
+        return;
+    }
+
+    // The layout belongs to the network thread
+    auto update = [this, width, height]() {
+        if (mLayoutManager->updateScreenSize(mOwnHandle, width, height)) {
+            broadcastLayoutUpdate();
+        }
+    };
+    if (mWsServer && mWsServer->isRunning()) {
+        mWsServer->post(std::move(update));
+    } else {
+        update();
+    }
+}
+
+void Konflikt::onWebSocketMessage(std::string_view message, void *connection)
 {
+    {
+        auto now = LinkQuality::Clock::now();
+        std::lock_guard<std::mutex> lock(mLinksMutex);
+        if (mConfig.role == InstanceRole::Client) {
+            mLastServerMessage = now;
+        } else if (auto it = mLinks.find(connection); it != mLinks.end()) {
+            it->second.received(now);
+        }
+    }
+
     auto msgType = getMessageType(message);
     if (!msgType) {
         log("error", "Failed to parse message type");
@@ -1811,13 +2467,17 @@ void Konflikt::onWebSocketMessage(const std::string &message, void *connection)
         if (resp)
             handleHandshakeResponse(*resp);
     } else if (*msgType == "input_event") {
-        auto ev = fromJson<InputEventMessage>(message);
-        if (ev)
-            handleInputEvent(*ev);
+        // Decoded in place so steady-state input does not allocate
+        if (fromJson(message, mReceivedInput))
+            handleInputEvent(mReceivedInput);
     } else if (*msgType == "client_registration") {
         auto reg = fromJson<ClientRegistrationMessage>(message);
         if (reg)
             handleClientRegistration(*reg);
+    } else if (*msgType == "screen_geometry_update") {
+        auto sg = fromJson<ScreenGeometryUpdateMessage>(message);
+        if (sg)
+            handleScreenGeometryUpdate(*sg);
     } else if (*msgType == "layout_assignment") {
         auto la = fromJson<LayoutAssignmentMessage>(message);
         if (la)
@@ -1842,70 +2502,242 @@ void Konflikt::onWebSocketMessage(const std::string &message, void *connection)
         auto ss = fromJson<ServerShutdownMessage>(message);
         if (ss)
             handleServerShutdown(*ss);
+    } else if (*msgType == "heartbeat") {
+        auto hb = fromJson<HeartbeatMessage>(message);
+        if (hb)
+            handleHeartbeat(*hb, connection);
+    } else if (*msgType == "state_reset") {
+        auto sr = fromJson<StateResetMessage>(message);
+        if (sr)
+            handleStateReset(*sr);
     }
 }
 
 void Konflikt::onClientConnected(void *connection)
 {
     log("log", "Client connected");
-    // Connection tracking happens after handshake
-    (void)connection;
+    // Connection tracking happens after handshake; link health starts now
+    std::lock_guard<std::mutex> lock(mLinksMutex);
+    mLinks.emplace(connection, LinkQuality());
 }
 
 void Konflikt::onClientDisconnected(void *connection)
 {
-    auto it = mConnectionToInstanceId.find(connection);
-    if (it != mConnectionToInstanceId.end()) {
-        std::string instanceId = it->second;
+    {
+        std::lock_guard<std::mutex> lock(mLinksMutex);
+        mLinks.erase(connection);
+    }
+
+    auto it = mConnectionToInstance.find(connection);
+    if (it != mConnectionToInstance.end()) {
+        InstanceHandle handle = it->second;
+        std::string instanceId = mInstances.id(handle);
+        mConnectionToInstance.erase(it);
+
+        if (mLayoutManager) {
+            mLayoutManager->setClientOnline(handle, false);
+        }
+
+        // Keep the session (layout slot, and activation for a moment) so a brief
+        // network drop doesn't reshuffle anything; expireSessions() ends it
+        ConnectedClient *client = mConnectedClients.find(handle);
+        if (client && !client->sessionToken.empty()) {
+            log("log", "Client disconnected: " + instanceId + " (resumable for " + std::to_string(SESSION_GRACE_MS) + " ms)");
+            client->disconnectedAt = monotonicNs();
+            return;
+        }
+
         log("log", "Client disconnected: " + instanceId);
 
         // If this was the active client, deactivate remote screen
-        if (instanceId == mActivatedClientId) {
+        if (handle == mActivatedClient) {
             deactivateRemoteScreen();
         }
-
-        if (mLayoutManager) {
-            mLayoutManager->setClientOnline(instanceId, false);
-        }
-        mConnectionToInstanceId.erase(it);
-        mConnectedClients.erase(instanceId);
+        endSession(handle);
     }
 }
 
-void Konflikt::handleHandshakeRequest(const HandshakeRequest &request, void *connection)
+void Konflikt::expireSessions()
 {
-    log("log", "Handshake from " + request.instanceName);
+    uint64_t now = monotonicNs();
+    // Erasing from the table leaves the iteration intact
+    for (const auto &[handle, client] : mConnectedClients) {
+        if (client.disconnectedAt == 0) {
+            continue;
+        }
 
-    // Track connection
-    mConnectionToInstanceId[connection] = request.instanceId;
+        uint64_t gone = (now - client.disconnectedAt) / NS_PER_MS;
+        if (handle == mActivatedClient && gone >= SESSION_ACTIVE_HOLD_MS) {
+            log("log", "Active client " + client.instanceId + " did not come back, deactivating");
+            deactivateRemoteScreen();
+        }
+        if (gone >= SESSION_GRACE_MS) {
+            log("log", "Session expired for " + client.instanceId);
+            endSession(handle);
+        }
+    }
+}
+
+void Konflikt::endSession(InstanceHandle handle)
+{
+    mConnectedClients.erase(handle);
+    if (mLayoutManager) {
+        mLayoutManager->unregisterClient(handle);
+    }
+    // A client claiming our own instance ID shares our handle; keep it
+    if (handle != mOwnHandle) {
+        mInstances.release(handle);
+    }
+}
+
+std::string Konflikt::generateSessionToken()
+{
+    std::random_device random;
+    std::stringstream ss;
+    for (int i = 0; i < 4; ++i) {
+        ss << std::hex << std::setw(8) << std::setfill('0') << random();
+    }
+    return ss.str();
+}
+
+void Konflikt::handleHandshakeRequest(const HandshakeRequest &request, void *connection)
+{
+    log("log", "Handshake from " + request.instanceName);
 
-    // Send response
     HandshakeResponse response;
     response.accepted = true;
     response.instanceId = mConfig.instanceId;
     response.instanceName = mConfig.instanceName;
     response.version = VERSION;
-    response.capabilities = { "input_events", "screen_info" };
+    response.capabilities = advertisedCapabilities();
+    if (*KONFLIKT_GIT_COMMIT) {
+        response.gitCommit = KONFLIKT_GIT_COMMIT;
+    }
     response.timestamp = timestamp();
 
+    InstanceHandle handle = mInstances.find(request.instanceId);
+    ConnectedClient *client = mConnectedClients.find(handle);
+    bool resume = request.resumeToken && client &&
+        !client->sessionToken.empty() && *request.resumeToken == client->sessionToken;
+
+    // Full: only clients we already know (resuming or re-registering) get in
+    if (mConfig.maxClients > 0 && !client &&
+        mConnectedClients.size() >= static_cast<size_t>(mConfig.maxClients)) {
+        log("log", "Rejecting " + request.instanceName + ": server full (" + std::to_string(mConfig.maxClients) + " clients)");
+        response.accepted = false;
+        mWsServer->send(connection, toJson(response));
+        return;
+    }
+
+    // Interned only once the handshake is accepted; endSession() releases it,
+    // so this only fails with MAX_INSTANCES sessions alive or in their grace period
+    if (handle == NO_INSTANCE) {
+        handle = mInstances.intern(request.instanceId);
+        if (handle == NO_INSTANCE) {
+            log("error", "Rejecting " + request.instanceName + ": no instance handle left");
+            response.accepted = false;
+            mWsServer->send(connection, toJson(response));
+            return;
+        }
+    }
+
+    // The client may have replaced a connection we haven't noticed is dead yet.
+    // Forget it either way, or its close would later mark this session offline.
+    for (auto it = mConnectionToInstance.begin(); it != mConnectionToInstance.end();) {
+        if (it->second == handle && it->first != connection) {
+            mWsServer->disconnect(it->first);
+            it = mConnectionToInstance.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (resume) {
+        client->disconnectedAt = 0;
+        if (mLayoutManager) {
+            mLayoutManager->setClientOnline(handle, true);
+        }
+        response.resumed = true;
+        log("log", "Session resumed for " + request.instanceName);
+    } else {
+        // Registration fills in the rest
+        client = &mConnectedClients[handle];
+        client->instanceId = request.instanceId;
+        client->displayName = request.instanceName;
+        client->sessionToken = generateSessionToken();
+        client->disconnectedAt = 0;
+    }
+
+    // Track connection
+    mConnectionToInstance[connection] = handle;
+
+    // Older clients never echo heartbeats; uWS's idle timeout covers them
+    {
+        std::lock_guard<std::mutex> lock(mLinksMutex);
+        if (auto it = mLinks.find(connection); it != mLinks.end()) {
+            it->second.setEchoesHeartbeats(hasCapability(request.capabilities, HEARTBEAT_CAPABILITY));
+        }
+    }
+
+    response.sessionToken = client->sessionToken;
+    response.handle = handle;
+    response.serverHandle = mOwnHandle;
     mWsServer->send(connection, toJson(response));
+
+    // Still the active screen: put the cursor back where it was
+    if (resume && handle == mActivatedClient && mHasVirtualCursor) {
+        VirtualCursor cursor = virtualCursor();
+        ActivateClientMessage msg;
+        msg.targetInstanceId = request.instanceId;
+        msg.cursorX = cursor.x;
+        msg.cursorY = cursor.y;
+        msg.timestamp = timestamp();
+        mWsServer->send(connection, toJson(msg));
+    }
 }
 
 void Konflikt::handleHandshakeResponse(const HandshakeResponse &response)
 {
     if (response.accepted) {
         mConnectedServerName = response.instanceName;
+        double rttMs = std::chrono::duration<double, std::milli>(LinkQuality::Clock::now() - mHandshakeSentAt).count();
+        rememberServer(mWsClient->host(), mWsClient->port(), rttMs);
+
+        bool resumed = response.resumed.value_or(false) && !mSessionToken.empty();
+        mSessionToken = response.sessionToken.value_or("");
+        mOwnHandle = response.handle.value_or(NO_INSTANCE);
+        mServerHandle = response.serverHandle.value_or(NO_INSTANCE);
+        {
+            std::lock_guard<std::mutex> lock(mLinksMutex);
+            mServerSendsHeartbeats = hasCapability(response.capabilities, HEARTBEAT_CAPABILITY);
+            mLastServerMessage = LinkQuality::Clock::now();
+        }
+        if (resumed) {
+            // Layout slot and clipboard sequence carry over; the server re-sends
+            // activate_client if we still have the cursor. The screen may have
+            // been resized while we were away.
+            log("log", "Session resumed with " + response.instanceName);
+            sendScreenGeometry();
+            return;
+        }
+
         log("log", "Handshake completed with " + response.instanceName);
+        mIsActiveInstance = false;
 
         // Send client registration
         ClientRegistrationMessage reg;
         reg.instanceId = mConfig.instanceId;
         reg.displayName = mConfig.instanceName;
         reg.machineId = mMachineId;
-        reg.screenWidth = mScreenBounds.width;
-        reg.screenHeight = mScreenBounds.height;
+        Rect bounds = screenBounds();
+        reg.screenWidth = bounds.width;
+        reg.screenHeight = bounds.height;
 
         mWsClient->send(toJson(reg));
+    } else {
+        // Counts as a failure, so reconnection moves on to another server if it knows one
+        log("error", "Server " + response.instanceName + " rejected the handshake");
+        mWsClient->disconnect();
     }
 }
 
@@ -1917,7 +2749,8 @@ void Konflikt::handleInputEvent(const InputEventMessage &message)
     }
 
     // Don't execute our own events
-    if (message.sourceInstanceId == mConfig.instanceId) {
+    if (message.source != NO_INSTANCE ? message.source == mOwnHandle
+                                      : message.sourceInstanceId == mConfig.instanceId) {
         return;
     }
 
@@ -1943,48 +2776,116 @@ void Konflikt::handleInputEvent(const InputEventMessage &message)
     else if (message.eventData.button == "middle")
         event.button = MouseButton::Middle;
 
-    if (message.eventType == "mouseMove" || message.eventType == "mousePress" ||
-        message.eventType == "mouseRelease") {
-        mPlatform->sendMouseEvent(event);
+    if (message.eventType == "mouseMove") {
+        event.type = EventType::MouseMove;
+        if (mJitterBuffer) {
+            mJitterBuffer->push(event, message.eventData.sentNs);
+        } else {
+            injectMouseMove(event);
+        }
+        return;
+    }
 
-        // Check for deactivation (cursor at left edge moving left)
-        if (message.eventType == "mouseMove") {
-            InputState state = mPlatform->getState();
-            if (state.x <= 1 && message.eventData.dx < 0) {
-                requestDeactivation();
+    // Anything else must land after the motion that preceded it
+    if (mJitterBuffer) {
+        mJitterBuffer->flush();
+    }
+
+    if (message.eventType == "mousePress" || message.eventType == "mouseRelease") {
+        {
+            bool press = message.eventType == "mousePress";
+            event.type = press ? EventType::MousePress : EventType::MouseRelease;
+
+            std::lock_guard<std::mutex> lock(mPressedStateMutex);
+            if (press) {
+                mInjectedState.pressButton(toUInt32(event.button));
+            } else if (mInjectedState.isButtonPressed(toUInt32(event.button))) {
+                mInjectedState.releaseButton(toUInt32(event.button));
+            } else {
+                return; // Already released by a state reset
             }
         }
+        std::lock_guard<std::mutex> lock(mInjectMutex);
+        mPlatform->sendMouseEvent(event);
     } else if (message.eventType == "scroll") {
         event.type = EventType::MouseScroll;
         event.state.scrollX = message.eventData.scrollX;
         event.state.scrollY = message.eventData.scrollY;
+        std::lock_guard<std::mutex> lock(mInjectMutex);
         mPlatform->sendMouseEvent(event);
     } else if (message.eventType == "keyPress" || message.eventType == "keyRelease") {
         event.type = message.eventType == "keyPress" ? EventType::KeyPress : EventType::KeyRelease;
+
+        // Prefer the platform-neutral usage; fall back to the sender's keycode
+        uint32_t wireKeycode = message.eventData.keycode;
+        uint16_t native = nativeKeycodeFromHidUsage(static_cast<uint16_t>(message.eventData.usage));
+        event.hidUsage = static_cast<uint16_t>(message.eventData.usage);
+        event.keycode = native != keycodes::NO_KEYCODE ? native : wireKeycode;
+
+        // Held keys are tracked by wire keycode (what the server's heartbeat reports)
+        {
+            std::lock_guard<std::mutex> lock(mPressedStateMutex);
+            if (event.type == EventType::KeyPress) {
+                mInjectedState.pressKey(wireKeycode);
+                if (wireKeycode < PressedState::MAX_KEYCODE)
+                    mInjectedKeycodes[wireKeycode] = event.keycode;
+            } else if (mInjectedState.isKeyPressed(wireKeycode)) {
+                mInjectedState.releaseKey(wireKeycode);
+                event.keycode = mInjectedKeycodes[wireKeycode];  // Release what was pressed
+            } else if (wireKeycode < PressedState::MAX_KEYCODE) {
+                return; // Already released by a state reset
+            }
+        }
+        std::lock_guard<std::mutex> lock(mInjectMutex);
         mPlatform->sendKeyEvent(event);
     }
 }
 
+void Konflikt::injectMouseMove(const Event &event)
+{
+    InputState state;
+    {
+        std::lock_guard<std::mutex> lock(mInjectMutex);
+        mPlatform->sendMouseEvent(event);
+        state = mPlatform->getState();
+    }
+
+    // Check for deactivation (cursor at left edge moving left). This may run on
+    // the jitter buffer's thread, so the request is made from the main loop.
+    if (state.x <= 1 && event.state.dx < 0 && !mDeactivationPosted.exchange(true)) {
+        post([this]() {
+            mDeactivationPosted = false;
+            requestDeactivation();
+        });
+    }
+}
+
 void Konflikt::handleClientRegistration(const ClientRegistrationMessage &message)
 {
     if (mConfig.role != InstanceRole::Server || !mLayoutManager) {
         return;
     }
 
+    // The handle was assigned at handshake
+    InstanceHandle handle = mInstances.find(message.instanceId);
+    if (handle == NO_INSTANCE) {
+        return;
+    }
+
     log("log", "Client registered: " + message.displayName);
 
-    // Track client details
-    ConnectedClient client;
+    // Track client details (the session token was issued at handshake)
+    ConnectedClient &client = mConnectedClients[handle];
     client.instanceId = message.instanceId;
     client.displayName = message.displayName;
     client.screenWidth = message.screenWidth;
     client.screenHeight = message.screenHeight;
     client.connectedAt = timestamp();
     client.active = false;
-    mConnectedClients[message.instanceId] = client;
+    client.disconnectedAt = 0;
 
     auto entry = mLayoutManager->registerClient(
-        message.instanceId,
+        handle,
         message.displayName,
         message.machineId,
         message.screenWidth,
@@ -1994,31 +2895,68 @@ void Konflikt::handleClientRegistration(const ClientRegistrationMessage &message
     LayoutAssignmentMessage assignment;
     assignment.position.x = entry.x;
     assignment.position.y = entry.y;
-    assignment.adjacency = mLayoutManager->getAdjacencyFor(message.instanceId);
-    for (const auto &screen : mLayoutManager->getLayout()) {
-        ScreenInfo info;
-        info.instanceId = screen.instanceId;
-        info.displayName = screen.displayName;
-        info.x = screen.x;
-        info.y = screen.y;
-        info.width = screen.width;
-        info.height = screen.height;
-        info.isServer = screen.isServer;
-        info.online = screen.online;
-        assignment.fullLayout.push_back(info);
-    }
+    assignment.adjacency = mLayoutManager->getAdjacencyFor(handle);
+    assignment.fullLayout = layoutScreens();
 
     broadcastToClients(toJson(assignment));
 }
 
+void Konflikt::sendScreenGeometry()
+{
+    ScreenGeometryUpdateMessage update;
+    update.instanceId = mConfig.instanceId;
+    Rect bounds = screenBounds();
+    update.screenWidth = bounds.width;
+    update.screenHeight = bounds.height;
+    update.timestamp = timestamp();
+    mWsClient->send(toJson(update));
+}
+
+void Konflikt::handleScreenGeometryUpdate(const ScreenGeometryUpdateMessage &message)
+{
+    if (mConfig.role != InstanceRole::Server || !mLayoutManager) {
+        return;
+    }
+
+    // Only registered clients have a slot to resize
+    InstanceHandle handle = mInstances.find(message.instanceId);
+    ConnectedClient *client = mConnectedClients.find(handle);
+    if (!client || message.screenWidth <= 0 || message.screenHeight <= 0) {
+        return;
+    }
+
+    client->screenWidth = message.screenWidth;
+    client->screenHeight = message.screenHeight;
+
+    if (!mLayoutManager->updateScreenSize(handle, message.screenWidth, message.screenHeight)) {
+        return;
+    }
+
+    log("log", "Client " + client->displayName + " resized to " + std::to_string(message.screenWidth) + "x" +
+                   std::to_string(message.screenHeight));
+
+    // Keep the virtual cursor on the screen it is driving
+    if (handle == mActivatedClient) {
+        std::lock_guard<std::mutex> lock(mCursorMutex);
+        mActiveRemoteScreenBounds = Rect(0, 0, message.screenWidth, message.screenHeight);
+        mVirtualCursor.x = std::clamp(mVirtualCursor.x, 0, message.screenWidth - 1);
+        mVirtualCursor.y = std::clamp(mVirtualCursor.y, 0, message.screenHeight - 1);
+    }
+
+    broadcastLayoutUpdate();
+}
+
 void Konflikt::handleLayoutAssignment(const LayoutAssignmentMessage &message)
 {
     if (mConfig.role != InstanceRole::Client) {
         return;
     }
 
-    mScreenBounds.x = message.position.x;
-    mScreenBounds.y = message.position.y;
+    {
+        std::lock_guard<std::mutex> lock(mCursorMutex);
+        mScreenBounds.x = message.position.x;
+        mScreenBounds.y = message.position.y;
+    }
 
     log("log", "Layout assigned: position (" + std::to_string(message.position.x) + ", " + std::to_string(message.position.y) + ")");
 }
@@ -2032,6 +2970,7 @@ void Konflikt::handleLayoutUpdate(const LayoutUpdateMessage &message)
     // Update our position from the layout
     for (const auto &screen : message.screens) {
         if (screen.instanceId == mConfig.instanceId) {
+            std::lock_guard<std::mutex> lock(mCursorMutex);
             mScreenBounds.x = screen.x;
             mScreenBounds.y = screen.y;
             break;
@@ -2045,6 +2984,7 @@ void Konflikt::handleActivateClient(const ActivateClientMessage &message)
         // Not for us
         if (mIsActiveInstance) {
             mIsActiveInstance = false;
+            releaseInjectedInput();
         }
         return;
     }
@@ -2058,6 +2998,7 @@ void Konflikt::handleActivateClient(const ActivateClientMessage &message)
     moveEvent.state.x = message.cursorX;
     moveEvent.state.y = message.cursorY;
     moveEvent.timestamp = timestamp();
+    std::lock_guard<std::mutex> lock(mInjectMutex);
     mPlatform->sendMouseEvent(moveEvent);
 }
 
@@ -2067,7 +3008,7 @@ void Konflikt::handleDeactivationRequest(const DeactivationRequestMessage &messa
         return;
     }
 
-    if (message.instanceId != mActivatedClientId) {
+    if (mActivatedClient == NO_INSTANCE || mInstances.find(message.instanceId) != mActivatedClient) {
         return;
     }
 
@@ -2087,7 +3028,7 @@ bool Konflikt::checkScreenTransition(int32_t x, int32_t y)
     }
 
     // Cooldown after deactivation
-    if (timestamp() - mLastDeactivationTime < 500) {
+    if (monotonicNs() - mLastDeactivationTime < 500 * NS_PER_MS) {
         return false;
     }
 
@@ -2095,19 +3036,20 @@ bool Konflikt::checkScreenTransition(int32_t x, int32_t y)
     Config::DisplayEdges edges = getEdgeSettingsForPoint(x, y);
 
     const int32_t EDGE_THRESHOLD = 1;
+    Rect bounds = screenBounds();
     Side edge;
     bool atEdge = false;
 
-    if (x <= mScreenBounds.x + EDGE_THRESHOLD && edges.left) {
+    if (x <= bounds.x + EDGE_THRESHOLD && edges.left) {
         edge = Side::Left;
         atEdge = true;
-    } else if (x >= mScreenBounds.x + mScreenBounds.width - EDGE_THRESHOLD - 1 && edges.right) {
+    } else if (x >= bounds.x + bounds.width - EDGE_THRESHOLD - 1 && edges.right) {
         edge = Side::Right;
         atEdge = true;
-    } else if (y <= mScreenBounds.y + EDGE_THRESHOLD && edges.top) {
+    } else if (y <= bounds.y + EDGE_THRESHOLD && edges.top) {
         edge = Side::Top;
         atEdge = true;
-    } else if (y >= mScreenBounds.y + mScreenBounds.height - EDGE_THRESHOLD - 1 && edges.bottom) {
+    } else if (y >= bounds.y + bounds.height - EDGE_THRESHOLD - 1 && edges.bottom) {
         edge = Side::Bottom;
         atEdge = true;
     }
@@ -2116,40 +3058,44 @@ bool Konflikt::checkScreenTransition(int32_t x, int32_t y)
         return false;
     }
 
-    auto target = mLayoutManager->getTransitionTargetAtEdge(mConfig.instanceId, edge, x, y);
+    auto target = mLayoutManager->getTransitionTargetAtEdge(mOwnHandle, edge, x, y);
     if (!target) {
         return false;
     }
 
     // Only activate once
-    if (mActivatedClientId == target->targetScreen.instanceId) {
+    if (mActivatedClient == target->targetScreen.handle) {
         return true;
     }
 
-    activateClient(target->targetScreen.instanceId, target->newX, target->newY);
+    activateClient(target->targetScreen.handle, target->newX, target->newY);
     return true;
 }
 
-void Konflikt::activateClient(const std::string &targetInstanceId, int32_t cursorX, int32_t cursorY)
+void Konflikt::activateClient(InstanceHandle target, int32_t cursorX, int32_t cursorY)
 {
+    // Capture thread: everything up to the message works on handles
+
+    // Keys held on the previous client will never see their release
+    if (mActivatedClient != NO_INSTANCE && mActivatedClient != target) {
+        sendStateReset(mActivatedClient);
+    }
+    mPointerAccelerator.reset();
+
     // Clear active flag on previous client
-    if (!mActivatedClientId.empty()) {
-        auto prevIt = mConnectedClients.find(mActivatedClientId);
-        if (prevIt != mConnectedClients.end()) {
-            prevIt->second.active = false;
-        }
+    if (ConnectedClient *previous = mConnectedClients.find(mActivatedClient)) {
+        previous->active = false;
     }
 
-    mActivatedClientId = targetInstanceId;
+    mActivatedClient = target;
 
     // Set active flag on new client
-    auto it = mConnectedClients.find(targetInstanceId);
-    if (it != mConnectedClients.end()) {
-        it->second.active = true;
+    if (ConnectedClient *client = mConnectedClients.find(target)) {
+        client->active = true;
     }
 
     ActivateClientMessage msg;
-    msg.targetInstanceId = targetInstanceId;
+    msg.targetInstanceId = mInstances.id(target);
     msg.cursorX = cursorX;
     msg.cursorY = cursorY;
     msg.timestamp = timestamp();
@@ -2157,42 +3103,56 @@ void Konflikt::activateClient(const std::string &targetInstanceId, int32_t curso
     broadcastToClients(toJson(msg));
 
     // Set up virtual cursor
-    mVirtualCursor.x = cursorX;
-    mVirtualCursor.y = cursorY;
-    mHasVirtualCursor = true;
-
-    auto screen = mLayoutManager->getScreen(targetInstanceId);
-    if (screen) {
-        mActiveRemoteScreenBounds = Rect(0, 0, screen->width, screen->height);
+    auto screen = mLayoutManager->getScreen(target);
+    {
+        std::lock_guard<std::mutex> lock(mCursorMutex);
+        mVirtualCursor.x = cursorX;
+        mVirtualCursor.y = cursorY;
+        if (screen) {
+            mActiveRemoteScreenBounds = Rect(0, 0, screen->width, screen->height);
+        }
     }
+    mHasVirtualCursor = true;
 
     // Hide cursor on server
     mPlatform->hideCursor();
     mIsActiveInstance = false;
 
-    log("log", "Activated client " + targetInstanceId);
+    log("log", "Activated client " + msg.targetInstanceId);
 }
 
 void Konflikt::deactivateRemoteScreen()
 {
+    if (mActivatedClient != NO_INSTANCE) {
+        sendStateReset(mActivatedClient);
+    }
+
     // Clear active flag on deactivated client
-    if (!mActivatedClientId.empty()) {
-        auto it = mConnectedClients.find(mActivatedClientId);
-        if (it != mConnectedClients.end()) {
-            it->second.active = false;
-        }
+    if (ConnectedClient *client = mConnectedClients.find(mActivatedClient)) {
+        client->active = false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mPendingInputMutex);
+        mHasPendingScroll = false;
+        mHasPendingMotion = false;
     }
 
-    mVirtualCursor = { 0, 0 };
     mHasVirtualCursor = false;
-    mActivatedClientId.clear();
-    mActiveRemoteScreenBounds = Rect();
+    mActivatedClient = NO_INSTANCE;
+    Rect bounds;
+    {
+        std::lock_guard<std::mutex> lock(mCursorMutex);
+        mVirtualCursor = { 0, 0 };
+        mActiveRemoteScreenBounds = Rect();
+        bounds = mScreenBounds;
+    }
 
     // Show cursor
     mPlatform->showCursor();
 
     // Warp cursor to right edge
-    int32_t rightEdgeX = mScreenBounds.x + mScreenBounds.width - 1;
+    int32_t rightEdgeX = bounds.x + bounds.width - 1;
     InputState state = mPlatform->getState();
 
     Event moveEvent;
@@ -2203,17 +3163,17 @@ void Konflikt::deactivateRemoteScreen()
     mPlatform->sendMouseEvent(moveEvent);
 
     mIsActiveInstance = true;
-    mLastDeactivationTime = timestamp();
+    mLastDeactivationTime = monotonicNs();
 
     log("log", "Deactivated remote screen");
 }
 
 void Konflikt::requestDeactivation()
 {
-    if (timestamp() - mLastDeactivationRequest < 500) {
+    if (monotonicNs() - mLastDeactivationRequest < 500 * NS_PER_MS) {
         return;
     }
-    mLastDeactivationRequest = timestamp();
+    mLastDeactivationRequest = monotonicNs();
 
     DeactivationRequestMessage msg;
     msg.instanceId = mConfig.instanceId;
@@ -2223,21 +3183,48 @@ void Konflikt::requestDeactivation()
     log("log", "Requested deactivation");
 }
 
-void Konflikt::broadcastInputEvent(const std::string &eventType, const InputEventData &data)
+void Konflikt::broadcastInputEvent(std::string_view eventType, const InputEventData &data)
 {
     updateInputStats(eventType);
 
-    InputEventMessage msg;
-    msg.sourceInstanceId = mConfig.instanceId;
-    msg.sourceDisplayId = mDisplayId;
-    msg.sourceMachineId = mMachineId;
-    msg.eventType = eventType;
-    msg.eventData = data;
+    // Called from the capture thread and the main loop; each keeps its own
+    // message and JSON buffer
+    thread_local InputEventEncoder encoder;
+    encoder.setSource(mOwnHandle);
 
-    broadcastToClients(toJson(msg));
+    std::string_view json = encoder.encode(eventType, data);
+    if (!json.empty()) {
+        broadcastToClients(json);
+    }
+}
+
+void Konflikt::broadcastLayoutUpdate()
+{
+    LayoutUpdateMessage update;
+    update.screens = layoutScreens();
+    update.timestamp = timestamp();
+    broadcastToClients(toJson(update));
 }
 
-void Konflikt::broadcastToClients(const std::string &message)
+std::vector<ScreenInfo> Konflikt::layoutScreens() const
+{
+    std::vector<ScreenInfo> screens;
+    for (const auto &screen : mLayoutManager->getLayout()) {
+        ScreenInfo info;
+        info.instanceId = screen.instanceId;
+        info.displayName = screen.displayName;
+        info.x = screen.x;
+        info.y = screen.y;
+        info.width = screen.width;
+        info.height = screen.height;
+        info.isServer = screen.isServer;
+        info.online = screen.online;
+        screens.push_back(info);
+    }
+    return screens;
+}
+
+void Konflikt::broadcastToClients(std::string_view message)
 {
     if (mWsServer) {
         mWsServer->broadcast(message);
@@ -2332,9 +3319,10 @@ std::string Konflikt::generateMachineId()
 std::string Konflikt::generateDisplayId()
 {
     Desktop desktop = mPlatform->getDesktop();
+    Rect bounds = screenBounds();
     std::string input = mMachineId + "-" +
         std::to_string(desktop.width) + "x" + std::to_string(desktop.height) + "-" +
-        std::to_string(mScreenBounds.x) + "," + std::to_string(mScreenBounds.y);
+        std::to_string(bounds.x) + "," + std::to_string(bounds.y);
 
     unsigned char hash[SHA256_DIGEST_LENGTH];
     SHA256(reinterpret_cast<const unsigned char *>(input.c_str()), input.length(), hash);
@@ -2376,17 +3364,317 @@ void Konflikt::handleServerShutdown(const ServerShutdownMessage &message)
 {
     log("log", "Server shutting down: " + message.reason);
 
+    releaseInjectedInput();
+
     // Mark that we're expecting reconnection (graceful shutdown)
     mExpectingReconnect = true;
     mExpectedRestartDelayMs = message.delayMs;
 
     // Reset reconnection attempts since this is a graceful shutdown
-    mReconnectAttempts = 0;
+    resetReconnect();
 
     // Update status to inform user
     updateStatus(ConnectionStatus::Disconnected, "Server shutdown: " + message.reason);
 }
 
+void Konflikt::handleHeartbeat(const HeartbeatMessage &message, void *connection)
+{
+    if (mConfig.role == InstanceRole::Server) {
+        {
+            std::lock_guard<std::mutex> lock(mLinksMutex);
+            auto it = mLinks.find(connection);
+            if (it != mLinks.end()) {
+                it->second.heartbeatAcked(message.seq, LinkQuality::Clock::now());
+            }
+        }
+
+        // Client echo: report drift, the client corrects itself on our next heartbeat
+        std::lock_guard<std::mutex> lock(mPressedStateMutex);
+        auto client = mConnectionToInstance.find(connection);
+        bool active = client != mConnectionToInstance.end() && client->second == mActivatedClient;
+        uint64_t expected = active ? mForwardedState.digest() : 0;
+        if (message.pressedDigest != expected) {
+            log("verbose", "Held input mismatch on " + message.instanceId + " (" + std::to_string(message.pressedKeys.size()) + " keys held)");
+        }
+        return;
+    }
+
+    // What the server believes we should be holding
+    PressedState expected;
+    if (message.activeInstanceId == mConfig.instanceId) {
+        for (uint32_t keycode : message.pressedKeys) {
+            expected.pressKey(keycode);
+        }
+        expected.pressButton(message.pressedButtons);
+    }
+
+    bool drift;
+    {
+        std::lock_guard<std::mutex> lock(mPressedStateMutex);
+        drift = mInjectedState.digest() != expected.digest();
+    }
+    if (drift) {
+        log("verbose", "Held input out of sync with server, releasing stale keys");
+        reconcileInjectedInput(expected);
+    }
+
+    HeartbeatMessage reply;
+    reply.instanceId = mConfig.instanceId;
+    {
+        std::lock_guard<std::mutex> lock(mPressedStateMutex);
+        reply.pressedDigest = mInjectedState.digest();
+        reply.pressedKeys = mInjectedState.keys();
+        reply.pressedButtons = mInjectedState.buttons();
+    }
+    reply.seq = message.seq;
+    reply.echoTimestamp = message.timestamp;
+    reply.timestamp = timestamp();
+    if (mWsClient) {
+        mWsClient->send(toJson(reply));
+    }
+}
+
+void Konflikt::handleStateReset(const StateResetMessage &message)
+{
+    if (message.targetInstanceId != mConfig.instanceId) {
+        return;
+    }
+    releaseInjectedInput();
+}
+
+void Konflikt::queueScroll(const Event &event)
+{
+    VirtualCursor cursor = virtualCursor();
+    {
+        std::lock_guard<std::mutex> lock(mPendingInputMutex);
+        if (!mHasPendingScroll) {
+            mPendingScroll = {};
+            mHasPendingScroll = true;
+        }
+        mPendingScroll.x = cursor.x;
+        mPendingScroll.y = cursor.y;
+        mPendingScroll.scrollX += event.state.scrollX;
+        mPendingScroll.scrollY += event.state.scrollY;
+        mPendingScroll.timestamp = event.timestamp;
+        mPendingScroll.keyboardModifiers = event.state.keyboardModifiers;
+    }
+
+    flushPendingInput();
+}
+
+void Konflikt::queueMotion(const InputEventData &data)
+{
+    std::lock_guard<std::mutex> lock(mPendingInputMutex);
+    int32_t dx = mHasPendingMotion ? mPendingMotion.dx : 0;
+    int32_t dy = mHasPendingMotion ? mPendingMotion.dy : 0;
+
+    // Positions are absolute, so only the latest matters; deltas add up
+    mPendingMotion = data;
+    mPendingMotion.dx += dx;
+    mPendingMotion.dy += dy;
+    mHasPendingMotion = true;
+}
+
+void Konflikt::flushPendingInput(bool force)
+{
+    std::optional<InputEventData> motion;
+    std::optional<InputEventData> scroll;
+    {
+        std::lock_guard<std::mutex> lock(mPendingInputMutex);
+        if (mHasPendingMotion) {
+            motion = mPendingMotion;
+            mHasPendingMotion = false;
+        }
+
+        uint64_t now = monotonicNs();
+        if (mHasPendingScroll && (force || now - mLastScrollSent >= SCROLL_FLUSH_INTERVAL_MS * NS_PER_MS)) {
+            scroll = mPendingScroll;
+            mHasPendingScroll = false;
+            mLastScrollSent = now;
+        }
+    }
+
+    if (motion) {
+        broadcastInputEvent("mouseMove", *motion);
+    }
+    if (scroll) {
+        broadcastInputEvent("scroll", *scroll);
+    }
+}
+
+void Konflikt::checkLinks()
+{
+    auto now = LinkQuality::Clock::now();
+
+    if (mConfig.role == InstanceRole::Client) {
+        // The server heartbeats every HEARTBEAT_INTERVAL_MS; silence means it is gone
+        if (mConnectionStatus != ConnectionStatus::Connected || !mWsClient) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mLinksMutex);
+            if (!mServerSendsHeartbeats || now - mLastServerMessage <= LinkQuality::DEAD_TIMEOUT) {
+                return;
+            }
+            mLastServerMessage = now;
+        }
+        log("log", "No message from server in " + std::to_string(LinkQuality::DEAD_TIMEOUT.count()) + " ms, disconnecting");
+        mWsClient->disconnect();
+        return;
+    }
+
+    // mConnectionToInstance belongs to the network thread
+    if (mWsServer) {
+        mWsServer->post([this]() {
+            checkClientLinks();
+        });
+    }
+}
+
+void Konflikt::checkClientLinks()
+{
+    auto now = LinkQuality::Clock::now();
+    std::vector<void *> dead;
+    bool activeDegraded = false;
+    {
+        std::lock_guard<std::mutex> lock(mLinksMutex);
+        for (auto &[connection, link] : mLinks) {
+            if (link.isDead(now)) {
+                dead.push_back(connection);
+                continue;
+            }
+            auto it = mConnectionToInstance.find(connection);
+            if (it != mConnectionToInstance.end() && it->second == mActivatedClient && link.isDegraded(now)) {
+                activeDegraded = true;
+            }
+        }
+        for (void *connection : dead) {
+            mLinks.erase(connection);
+        }
+    }
+
+    for (void *connection : dead) {
+        auto it = mConnectionToInstance.find(connection);
+        log("log", "Closing unresponsive connection" + (it != mConnectionToInstance.end() ? " to " + mInstances.id(it->second) : std::string()));
+        mWsServer->disconnect(connection);
+    }
+
+    if (activeDegraded != mCoalesceMotion.exchange(activeDegraded)) {
+        log("log", activeDegraded ? "Link to active client degraded, coalescing mouse motion"
+                                  : "Link to active client recovered");
+    }
+}
+
+void Konflikt::sendHeartbeat()
+{
+    HeartbeatMessage message;
+    message.instanceId = mConfig.instanceId;
+    message.activeInstanceId = mInstances.id(mActivatedClient);
+
+    std::lock_guard<std::mutex> forward(mForwardMutex);
+    {
+        std::lock_guard<std::mutex> lock(mPressedStateMutex);
+        message.pressedDigest = mForwardedState.digest();
+        message.pressedKeys = mForwardedState.keys();
+        message.pressedButtons = mForwardedState.buttons();
+    }
+    message.seq = ++mHeartbeatSeq;
+    message.timestamp = timestamp();
+
+    {
+        auto now = LinkQuality::Clock::now();
+        std::lock_guard<std::mutex> lock(mLinksMutex);
+        for (auto &[connection, link] : mLinks) {
+            link.heartbeatSent(message.seq, now);
+        }
+    }
+
+    broadcastToClients(toJson(message));
+}
+
+void Konflikt::sendStateReset(InstanceHandle client)
+{
+    std::lock_guard<std::mutex> forward(mForwardMutex);
+    {
+        std::lock_guard<std::mutex> lock(mPressedStateMutex);
+        mForwardedState.clear();
+    }
+
+    StateResetMessage message;
+    message.targetInstanceId = mInstances.id(client);
+    message.timestamp = timestamp();
+    broadcastToClients(toJson(message));
+}
+
+void Konflikt::releaseInjectedInput()
+{
+    if (mConfig.role != InstanceRole::Client || !mPlatform) {
+        return;
+    }
+
+    // Queued motion belongs to the session being torn down
+    if (mJitterBuffer) {
+        mJitterBuffer->clear();
+    }
+    reconcileInjectedInput({});
+}
+
+void Konflikt::reconcileInjectedInput(const PressedState &keep)
+{
+    if (mConfig.role != InstanceRole::Client || !mPlatform) {
+        return;
+    }
+
+    PressedState held;
+    {
+        std::lock_guard<std::mutex> lock(mPressedStateMutex);
+        held = mInjectedState;
+
+        // Keep only what is both held and expected; never synthesize presses
+        PressedState remaining;
+        for (uint32_t keycode : held.keys()) {
+            if (keep.isKeyPressed(keycode))
+                remaining.pressKey(keycode);
+        }
+        remaining.pressButton(held.buttons() & keep.buttons());
+        mInjectedState = remaining;
+    }
+
+    std::unique_lock<std::mutex> inject(mInjectMutex);
+    InputState state = mPlatform->getState();
+    int released = 0;
+
+    for (uint32_t keycode : held.keys()) {
+        if (keep.isKeyPressed(keycode)) {
+            continue;
+        }
+        Event event;
+        event.type = EventType::KeyRelease;
+        event.timestamp = timestamp();
+        event.keycode = mInjectedKeycodes[keycode];
+        mPlatform->sendKeyEvent(event);
+        ++released;
+    }
+
+    for (MouseButton button : { MouseButton::Left, MouseButton::Right, MouseButton::Middle }) {
+        if (!held.isButtonPressed(toUInt32(button)) || keep.isButtonPressed(toUInt32(button))) {
+            continue;
+        }
+        Event event;
+        event.type = EventType::MouseRelease;
+        event.timestamp = timestamp();
+        event.state = state;
+        event.button = button;
+        mPlatform->sendMouseEvent(event);
+        ++released;
+    }
+    inject.unlock();
+
+    if (released > 0) {
+        log("log", "Released " + std::to_string(released) + " held keys/buttons");
+    }
+}
+
 void Konflikt::notifyShutdown(const std::string &reason, int32_t delayMs)
 {
     if (mConfig.role != InstanceRole::Server) {
@@ -2414,12 +3702,13 @@ void Konflikt::setEdgeTransitions(bool left, bool right, bool top, bool bottom)
     mConfig.edgeRight = right;
     mConfig.edgeTop = top;
     mConfig.edgeBottom = bottom;
+    rebuildEdges();
     log("log", std::string("Edge transitions: ") + "L=" + (left ? "on" : "off") + " " + "R=" + (right ? "on" : "off") + " " + "T=" + (top ? "on" : "off") + " " + "B=" + (bottom ? "on" : "off"));
 }
 
 bool Konflikt::saveConfig(const std::string &path)
 {
-    bool success = ConfigManager::save(mConfig, path);
+    bool success = ConfigManager::save(mConfig, path.empty() ? mConfig.configPath : path);
     if (success) {
         log("log", "Configuration saved");
     } else {
@@ -2428,6 +3717,116 @@ bool Konflikt::saveConfig(const std::string &path)
     return success;
 }
 
+void Konflikt::checkConfigFile()
+{
+    if (!mConfigWatcher) {
+        return;
+    }
+
+    if (mConfigWatcher->poll()) {
+        mConfigReloadAt = monotonicNs() + CONFIG_RELOAD_DELAY_MS * NS_PER_MS;
+    }
+    if (mConfigReloadAt == 0 || monotonicNs() < mConfigReloadAt) {
+        return;
+    }
+    mConfigReloadAt = 0;
+
+    // Parsed here rather than on the capture or network thread
+    std::optional<Config> loaded = ConfigManager::load(mConfigWatcher->path());
+    if (!loaded) {
+        if (std::filesystem::exists(mConfigWatcher->path())) {
+            log("error", "Ignoring invalid config file " + mConfigWatcher->path() + ", keeping the running config");
+        }
+        return;
+    }
+
+    Config before = std::move(mFileConfig);
+    mFileConfig = *loaded;
+    if (mWsServer && mWsServer->isRunning()) {
+        mWsServer->post([this, before = std::move(before), after = std::move(*loaded)]() {
+            applyConfigChanges(before, after);
+        });
+    } else {
+        applyConfigChanges(before, *loaded);
+    }
+}
+
+void Konflikt::applyConfigChanges(const Config &before, const Config &after)
+{
+    // Only settings edited in the file are applied, so command line options
+    // and API changes to anything else stay in effect
+    std::vector<std::string> applied;
+    std::vector<std::string> restart;
+    auto apply = [&](auto &current, const auto &was, const auto &now, const char *name) {
+        if (was == now || current == now) {
+            return false;
+        }
+        current = now;
+        applied.push_back(name);
+        return true;
+    };
+    auto needsRestart = [&](const auto &current, const auto &was, const auto &now, const char *name) {
+        if (was != now && current != now) {
+            restart.push_back(name);
+        }
+    };
+
+    bool edges = apply(mConfig.edgeLeft, before.edgeLeft, after.edgeLeft, "edgeLeft");
+    edges |= apply(mConfig.edgeRight, before.edgeRight, after.edgeRight, "edgeRight");
+    edges |= apply(mConfig.edgeTop, before.edgeTop, after.edgeTop, "edgeTop");
+    edges |= apply(mConfig.edgeBottom, before.edgeBottom, after.edgeBottom, "edgeBottom");
+    edges |= apply(mConfig.displayEdges, before.displayEdges, after.displayEdges, "displayEdges");
+    if (edges) {
+        rebuildEdges();
+    }
+    if (apply(mConfig.keyRemap, before.keyRemap, after.keyRemap, "keyRemap")) {
+        rebuildKeyRemap();
+    }
+    if (apply(mConfig.lockCursorHotkey, before.lockCursorHotkey, after.lockCursorHotkey, "lockCursorHotkey")) {
+        mLockCursorHotkey = mConfig.lockCursorHotkey;
+    }
+    apply(mConfig.lockCursorToScreen, before.lockCursorToScreen, after.lockCursorToScreen, "lockCursorToScreen");
+    apply(mConfig.verbose, before.verbose, after.verbose, "verbose");
+    apply(mConfig.logKeycodes, before.logKeycodes, after.logKeycodes, "logKeycodes");
+    bool pointer = apply(mConfig.pointerSpeed, before.pointerSpeed, after.pointerSpeed, "pointerSpeed");
+    pointer |= apply(mConfig.pointerAcceleration, before.pointerAcceleration, after.pointerAcceleration, "pointerAcceleration");
+    pointer |= apply(mConfig.pointerAccelerationThreshold, before.pointerAccelerationThreshold,
+                     after.pointerAccelerationThreshold, "pointerAccelerationThreshold");
+    if (pointer) {
+        rebuildPointerCurve();
+    }
+
+    // Sockets, threads and identity are set up once
+    needsRestart(mConfig.role, before.role, after.role, "role");
+    needsRestart(mConfig.instanceName, before.instanceName, after.instanceName, "instanceName");
+    needsRestart(mConfig.port, before.port, after.port, "port");
+    needsRestart(mConfig.maxClients, before.maxClients, after.maxClients, "maxClients");
+    needsRestart(mConfig.serverHost, before.serverHost, after.serverHost, "serverHost");
+    needsRestart(mConfig.serverPort, before.serverPort, after.serverPort, "serverPort");
+    needsRestart(mConfig.useTLS, before.useTLS, after.useTLS, "useTLS");
+    needsRestart(mConfig.tlsCertFile, before.tlsCertFile, after.tlsCertFile, "tlsCertFile");
+    needsRestart(mConfig.tlsKeyFile, before.tlsKeyFile, after.tlsKeyFile, "tlsKeyFile");
+    needsRestart(mConfig.uiPath, before.uiPath, after.uiPath, "uiPath");
+    needsRestart(mConfig.jitterBufferMs, before.jitterBufferMs, after.jitterBufferMs, "jitterBufferMs");
+    needsRestart(mConfig.captureThread, before.captureThread, after.captureThread, "captureThread");
+    needsRestart(mConfig.networkThread, before.networkThread, after.networkThread, "networkThread");
+    needsRestart(mConfig.clientThread, before.clientThread, after.clientThread, "clientThread");
+
+    auto join = [](const std::vector<std::string> &names) {
+        std::string result;
+        for (const std::string &name : names) {
+            result += (result.empty() ? "" : ", ") + name;
+        }
+        return result;
+    };
+    if (!applied.empty()) {
+        log("log", "Config file changed, applied: " + join(applied));
+    }
+    if (!restart.empty()) {
+        log("log", "Config file changed, restart to apply: " + join(restart));
+    }
+}
+
 void Konflikt::checkClipboardChange()
 {
     if (!mPlatform) {
@@ -2435,8 +3834,8 @@ void Konflikt::checkClipboardChange()
     }
 
     // Poll clipboard periodically (every 500ms)
-    uint64_t now = timestamp();
-    if (now - mLastClipboardCheck < 500) {
+    uint64_t now = monotonicNs();
+    if (now - mLastClipboardCheck < 500 * NS_PER_MS) {
         return;
     }
     mLastClipboardCheck = now;
@@ -2476,6 +3875,99 @@ void Konflikt::broadcastClipboard(const std::string &text)
     }
 }
 
+void Konflikt::checkReconnect()
+{
+    if (mNetworkMonitor && mNetworkMonitor->poll() && mConnectionStatus != ConnectionStatus::Connected) {
+        log("log", "Network changed, retrying connection now");
+        resetReconnect();
+    }
+
+    if (!mAutoReconnect || mWsClient->host().empty() ||
+        (mConnectionStatus != ConnectionStatus::Disconnected && mConnectionStatus != ConnectionStatus::Error)) {
+        return;
+    }
+
+    uint64_t now = monotonicNs();
+    uint64_t attempt = 0;
+    {
+        std::lock_guard<std::mutex> lock(mReconnectMutex);
+        if (mNextReconnectAt == 0) {
+            uint64_t delay = mReconnectBackoff.next();
+            if (mExpectingReconnect && mExpectedRestartDelayMs > 0 && mReconnectBackoff.attempts() == 1) {
+                // The server told us when it expects to be back
+                delay += static_cast<uint64_t>(mExpectedRestartDelayMs);
+            }
+            mNextReconnectAt = now + delay * NS_PER_MS;
+            return;
+        }
+        if (now < mNextReconnectAt) {
+            return;
+        }
+        mNextReconnectAt = 0;
+        attempt = mReconnectBackoff.attempts();
+    }
+
+    if (mExpectingReconnect) {
+        // The server said it is coming back; don't fail over
+        log("log", "Reconnecting after graceful server shutdown (attempt " + std::to_string(attempt) + ")");
+        updateStatus(ConnectionStatus::Connecting, "Reconnecting...");
+        mWsClient->reconnect();
+        return;
+    }
+
+    std::optional<ServerEndpoint> next;
+    if (mConfig.serverHost.empty()) {
+        // The last attempt failed or the connection was lost; try the next best server
+        std::lock_guard<std::mutex> lock(mServerCacheMutex);
+        mServerCache.failed({ mWsClient->host(), mWsClient->port() });
+        next = mServerCache.best();
+    }
+
+    if (next && (next->host != mWsClient->host() || next->port != mWsClient->port())) {
+        log("log", "Failing over to " + next->host + ":" + std::to_string(next->port) +
+            " (attempt " + std::to_string(attempt) + ")");
+        updateStatus(ConnectionStatus::Connecting, "Connecting to " + next->host + "...");
+        mWsClient->connect(next->host, next->port, "/ws");
+        return;
+    }
+
+    log("log", "Reconnection attempt " + std::to_string(attempt));
+    updateStatus(ConnectionStatus::Connecting, "Reconnecting...");
+    mWsClient->reconnect();
+}
+
+void Konflikt::resetReconnect()
+{
+    std::lock_guard<std::mutex> lock(mReconnectMutex);
+    mReconnectBackoff.reset();
+    mNextReconnectAt = 0;
+}
+
+void Konflikt::rememberServer(const std::string &host, int port, double rttMs)
+{
+    if (host.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mServerCacheMutex);
+        mServerCache.connected({ host, port }, rttMs, timestamp());
+    }
+    saveServerCache();
+}
+
+void Konflikt::saveServerCache()
+{
+    std::vector<CachedServer> servers;
+    {
+        std::lock_guard<std::mutex> lock(mServerCacheMutex);
+        servers = mServerCache.servers();
+    }
+    if (!ConfigManager::saveServerCache(servers)) {
+        log("error", "Failed to save server cache to " + ConfigManager::getStatePath());
+    }
+}
+
 void Konflikt::onServiceFound(const DiscoveredService &service)
 {
     log("log", "Discovered server: " + service.name + " at " + service.host + ":" + std::to_string(service.port));
@@ -2485,14 +3977,69 @@ void Konflikt::onServiceFound(const DiscoveredService &service)
         return;
     }
 
-    // Auto-connect if we're a client without a connection
-    if (mConfig.role == InstanceRole::Client &&
-        mConnectionStatus != ConnectionStatus::Connected &&
-        mConfig.serverHost.empty()) {
+    if (mConfig.role != InstanceRole::Client || !mConfig.serverHost.empty()) {
+        return;
+    }
+
+    // Servers that publish their details can be ruled out without connecting
+    if (service.info) {
+        if (std::string reason = incompatibility(*service.info); !reason.empty()) {
+            log("log", "Skipping " + service.name + ": " + reason);
+            return;
+        }
+        if (service.info->isFull()) {
+            log("log", "Skipping " + service.name + " for now: full (" + std::to_string(service.info->clients) + " clients)");
+            return;
+        }
+    }
+
+    bool added = false;
+    {
+        std::lock_guard<std::mutex> lock(mServerCacheMutex);
+        added = mServerCache.seen(service, timestamp());
+    }
+    if (added) {
+        saveServerCache();
+    }
+
+    // Auto-connect if we aren't connected or trying a cached server already;
+    // if that one fails, reconnection fails over to the best remaining server
+    if (mConnectionStatus == ConnectionStatus::Disconnected || mConnectionStatus == ConnectionStatus::Error ||
+        mWsClient->host().empty()) {
         connectToDiscoveredServer(service.host, service.port);
     }
 }
 
+ServiceInfo Konflikt::serviceInfo() const
+{
+    ServiceInfo info;
+    info.version = VERSION;
+    info.commit = KONFLIKT_GIT_COMMIT;
+    info.tls = mConfig.useTLS;
+    info.capabilities = advertisedCapabilities();
+    info.clients = mWsServer ? static_cast<int>(mWsServer->clientCount()) : 0;
+    info.maxClients = mConfig.maxClients;
+    return info;
+}
+
+std::string Konflikt::incompatibility(const ServiceInfo &info) const
+{
+    // Same major version speaks the same protocol
+    std::string major = info.version.substr(0, info.version.find('.'));
+    if (major != VERSION_MAJOR) {
+        return "version " + info.version + " (we are " + VERSION + ")";
+    }
+    if (info.tls != mConfig.useTLS) {
+        return info.tls ? "requires TLS" : "TLS not enabled";
+    }
+    for (const std::string &capability : PROTOCOL_CAPABILITIES) {
+        if (!hasCapability(info.capabilities, capability)) {
+            return "no " + capability + " support";
+        }
+    }
+    return "";
+}
+
 void Konflikt::onServiceLost(const std::string &name)
 {
     log("log", "Server disappeared: " + name);
@@ -2509,6 +4056,11 @@ void Konflikt::connectToDiscoveredServer(const std::string &host, int port)
         return;
     }
 
+    // Already trying this one (e.g. the last good server from the previous run)
+    if (mConnectionStatus == ConnectionStatus::Connecting && mWsClient->host() == host && mWsClient->port() == port) {
+        return;
+    }
+
     log("log", "Auto-connecting to discovered server: " + host + ":" + std::to_string(port));
     updateStatus(ConnectionStatus::Connecting, "Connecting to " + host + "...");
     mWsClient->connect(host, port, "/ws");
@@ -4,18 +4,23 @@
 
 namespace konflikt {
 
-LayoutManager::LayoutManager() = default;
+LayoutManager::LayoutManager(const InstanceRegistry &instances)
+    : mInstances(instances)
+{
+}
+
 LayoutManager::~LayoutManager() = default;
 
-void LayoutManager::setServerScreen(const std::string &instanceId,
+void LayoutManager::setServerScreen(InstanceHandle handle,
                                     const std::string &displayName,
                                     const std::string &machineId,
                                     int32_t width, int32_t height)
 {
-    mServerInstanceId = instanceId;
+    mServerHandle = handle;
 
     ScreenEntry entry;
-    entry.instanceId = instanceId;
+    entry.handle = handle;
+    entry.instanceId = mInstances.id(handle);
     entry.displayName = displayName;
     entry.machineId = machineId;
     entry.x = 0;
@@ -25,17 +30,18 @@ void LayoutManager::setServerScreen(const std::string &instanceId,
     entry.isServer = true;
     entry.online = true;
 
-    mScreens[instanceId] = entry;
+    mScreens[handle] = entry;
     notifyLayoutChanged();
 }
 
-ScreenEntry LayoutManager::registerClient(const std::string &instanceId,
+ScreenEntry LayoutManager::registerClient(InstanceHandle handle,
                                           const std::string &displayName,
                                           const std::string &machineId,
                                           int32_t width, int32_t height)
 {
     ScreenEntry entry;
-    entry.instanceId = instanceId;
+    entry.handle = handle;
+    entry.instanceId = mInstances.id(handle);
     entry.displayName = displayName;
     entry.machineId = machineId;
     entry.width = width;
@@ -43,33 +49,60 @@ ScreenEntry LayoutManager::registerClient(const std::string &instanceId,
     entry.isServer = false;
     entry.online = true;
 
-    // Position the client screen to the right of the server
-    // Find the rightmost screen
-    int32_t maxRight = 0;
-    for (const auto &[id, screen] : mScreens) {
-        maxRight = std::max(maxRight, screen.x + screen.width);
+    bool resized = false;
+    if (const ScreenEntry *existing = mScreens.find(handle)) {
+        // A known client re-registering keeps its slot
+        entry.x = existing->x;
+        entry.y = existing->y;
+        resized = existing->width != width || existing->height != height;
+    } else {
+        // Position the client screen to the right of the server
+        // Find the rightmost screen
+        int32_t maxRight = 0;
+        for (const auto &[other, screen] : mScreens) {
+            maxRight = std::max(maxRight, screen.x + screen.width);
+        }
+        entry.x = maxRight;
+        entry.y = 0;
     }
-    entry.x = maxRight;
-    entry.y = 0;
 
-    mScreens[instanceId] = entry;
+    mScreens[handle] = entry;
+    if (resized) {
+        // Its screen changed size while it was away; keep neighbours adjacent
+        arrangeScreens();
+    }
     notifyLayoutChanged();
 
-    return entry;
+    return mScreens[handle];
+}
+
+bool LayoutManager::updateScreenSize(InstanceHandle handle, int32_t width, int32_t height)
+{
+    ScreenEntry *screen = mScreens.find(handle);
+    if (!screen || (screen->width == width && screen->height == height)) {
+        return false;
+    }
+
+    screen->width = width;
+    screen->height = height;
+    arrangeScreens();
+    notifyLayoutChanged();
+    return true;
 }
 
-void LayoutManager::unregisterClient(const std::string &instanceId)
+void LayoutManager::unregisterClient(InstanceHandle handle)
 {
-    mScreens.erase(instanceId);
+    if (!mScreens.erase(handle)) {
+        return;
+    }
     arrangeScreens();
     notifyLayoutChanged();
 }
 
-void LayoutManager::setClientOnline(const std::string &instanceId, bool online)
+void LayoutManager::setClientOnline(InstanceHandle handle, bool online)
 {
-    auto it = mScreens.find(instanceId);
-    if (it != mScreens.end()) {
-        it->second.online = online;
+    if (ScreenEntry *screen = mScreens.find(handle)) {
+        screen->online = online;
         notifyLayoutChanged();
     }
 }
@@ -78,7 +111,7 @@ std::vector<ScreenEntry> LayoutManager::getLayout() const
 {
     std::vector<ScreenEntry> layout;
     layout.reserve(mScreens.size());
-    for (const auto &[id, screen] : mScreens) {
+    for (const auto &[handle, screen] : mScreens) {
         layout.push_back(screen);
     }
 
@@ -90,116 +123,107 @@ std::vector<ScreenEntry> LayoutManager::getLayout() const
     return layout;
 }
 
-std::optional<ScreenEntry> LayoutManager::getScreen(const std::string &instanceId) const
+std::optional<ScreenEntry> LayoutManager::getScreen(InstanceHandle handle) const
 {
-    auto it = mScreens.find(instanceId);
-    if (it != mScreens.end()) {
-        return it->second;
+    if (const ScreenEntry *screen = mScreens.find(handle)) {
+        return *screen;
     }
     return std::nullopt;
 }
 
-Adjacency LayoutManager::getAdjacencyFor(const std::string &instanceId) const
+Adjacency LayoutManager::getAdjacencyFor(InstanceHandle handle) const
 {
     Adjacency adj;
 
-    auto it = mScreens.find(instanceId);
-    if (it == mScreens.end()) {
+    const ScreenEntry *screen = mScreens.find(handle);
+    if (!screen) {
         return adj;
     }
 
-    const auto &screen = it->second;
+    auto idOf = [this](InstanceHandle other) -> std::optional<std::string> {
+        if (other == NO_INSTANCE) {
+            return std::nullopt;
+        }
+        return mInstances.id(other);
+    };
+    adj.left = idOf(neighbour(*screen, Side::Left));
+    adj.right = idOf(neighbour(*screen, Side::Right));
+    adj.top = idOf(neighbour(*screen, Side::Top));
+    adj.bottom = idOf(neighbour(*screen, Side::Bottom));
+    return adj;
+}
 
-    // Find adjacent screens
-    for (const auto &[id, other] : mScreens) {
-        if (id == instanceId)
+InstanceHandle LayoutManager::neighbour(const ScreenEntry &screen, Side side) const
+{
+    InstanceHandle result = NO_INSTANCE;
+    for (const auto &[handle, other] : mScreens) {
+        if (handle == screen.handle)
             continue;
 
-        // Left neighbor: other's right edge touches this screen's left edge
-        if (other.x + other.width == screen.x) {
-            adj.left = id;
-        }
-        // Right neighbor: this screen's right edge touches other's left edge
-        if (screen.x + screen.width == other.x) {
-            adj.right = id;
-        }
-        // Top neighbor: other's bottom edge touches this screen's top edge
-        if (other.y + other.height == screen.y) {
-            adj.top = id;
+        bool touches = false;
+        switch (side) {
+            case Side::Left:
+                // Other's right edge touches this screen's left edge
+                touches = other.x + other.width == screen.x;
+                break;
+            case Side::Right:
+                // This screen's right edge touches other's left edge
+                touches = screen.x + screen.width == other.x;
+                break;
+            case Side::Top:
+                // Other's bottom edge touches this screen's top edge
+                touches = other.y + other.height == screen.y;
+                break;
+            case Side::Bottom:
+                // This screen's bottom edge touches other's top edge
+                touches = screen.y + screen.height == other.y;
+                break;
         }
-        // Bottom neighbor: this screen's bottom edge touches other's top edge
-        if (screen.y + screen.height == other.y) {
-            adj.bottom = id;
+        if (touches) {
+            result = handle;
         }
     }
-
-    return adj;
+    return result;
 }
 
 std::optional<TransitionTarget> LayoutManager::getTransitionTargetAtEdge(
-    const std::string &fromInstanceId,
+    InstanceHandle from,
     Side edge,
     int32_t x, int32_t y) const
 {
-    auto fromIt = mScreens.find(fromInstanceId);
-    if (fromIt == mScreens.end()) {
+    const ScreenEntry *fromScreen = mScreens.find(from);
+    if (!fromScreen) {
         return std::nullopt;
     }
 
-    const auto &fromScreen = fromIt->second;
-    Adjacency adj = getAdjacencyFor(fromInstanceId);
-
-    std::optional<std::string> targetId;
-
-    switch (edge) {
-        case Side::Left:
-            targetId = adj.left;
-            break;
-        case Side::Right:
-            targetId = adj.right;
-            break;
-        case Side::Top:
-            targetId = adj.top;
-            break;
-        case Side::Bottom:
-            targetId = adj.bottom;
-            break;
-    }
-
-    if (!targetId) {
+    const ScreenEntry *targetScreen = mScreens.find(neighbour(*fromScreen, edge));
+    if (!targetScreen || !targetScreen->online) {
         return std::nullopt;
     }
 
-    auto targetIt = mScreens.find(*targetId);
-    if (targetIt == mScreens.end() || !targetIt->second.online) {
-        return std::nullopt;
-    }
-
-    const auto &targetScreen = targetIt->second;
-
     TransitionTarget target;
-    target.targetScreen = targetScreen;
+    target.targetScreen = *targetScreen;
 
     // Calculate new cursor position on the target screen
     switch (edge) {
         case Side::Left:
             // Coming from right edge of target screen
-            target.newX = targetScreen.width - 2;
-            target.newY = std::clamp(y - fromScreen.y, 0, targetScreen.height - 1);
+            target.newX = targetScreen->width - 2;
+            target.newY = std::clamp(y - fromScreen->y, 0, targetScreen->height - 1);
             break;
         case Side::Right:
             // Coming to left edge of target screen
             target.newX = 1;
-            target.newY = std::clamp(y - fromScreen.y, 0, targetScreen.height - 1);
+            target.newY = std::clamp(y - fromScreen->y, 0, targetScreen->height - 1);
             break;
         case Side::Top:
             // Coming from bottom edge of target screen
-            target.newX = std::clamp(x - fromScreen.x, 0, targetScreen.width - 1);
-            target.newY = targetScreen.height - 2;
+            target.newX = std::clamp(x - fromScreen->x, 0, targetScreen->width - 1);
+            target.newY = targetScreen->height - 2;
             break;
         case Side::Bottom:
             // Coming to top edge of target screen
-            target.newX = std::clamp(x - fromScreen.x, 0, targetScreen.width - 1);
+            target.newX = std::clamp(x - fromScreen->x, 0, targetScreen->width - 1);
             target.newY = 1;
             break;
     }
@@ -216,20 +240,20 @@ void LayoutManager::notifyLayoutChanged()
 
 void LayoutManager::arrangeScreens()
 {
-    // Re-arrange screens left to right after one is removed
-    std::vector<std::pair<std::string, ScreenEntry *>> screens;
-    for (auto &[id, screen] : mScreens) {
-        screens.emplace_back(id, &screen);
+    // Re-arrange screens left to right after one is removed or resized
+    std::vector<ScreenEntry *> screens;
+    for (auto [handle, screen] : mScreens) {
+        screens.push_back(&screen);
     }
 
     // Sort by original x position
     std::sort(screens.begin(), screens.end(), [](const auto &a, const auto &b) {
-        return a.second->x < b.second->x;
+        return a->x < b->x;
     });
 
     // Reposition
     int32_t currentX = 0;
-    for (auto &[id, screen] : screens) {
+    for (ScreenEntry *screen : screens) {
         screen->x = currentX;
         screen->y = 0;
         currentX += screen->width;
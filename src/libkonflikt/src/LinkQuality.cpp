@@ -0,0 +1,92 @@
+#include "konflikt/LinkQuality.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace konflikt {
+
+LinkQuality::LinkQuality(Clock::time_point now)
+    : mLastReceived(now)
+{
+}
+
+void LinkQuality::heartbeatSent(uint64_t seq, Clock::time_point now)
+{
+    expire(now);
+
+    // Reuse the oldest slot; an entry still active there was never echoed
+    auto slot = std::min_element(mPending.begin(), mPending.end(), [](const Pending &a, const Pending &b) {
+        return a.active != b.active ? !a.active : a.seq < b.seq;
+    });
+    if (slot->active) {
+        ++mLost;
+    }
+    *slot = { seq, now, true };
+    ++mSent;
+}
+
+void LinkQuality::heartbeatAcked(uint64_t seq, Clock::time_point now)
+{
+    received(now);
+
+    for (Pending &pending : mPending) {
+        if (!pending.active || pending.seq > seq) {
+            continue;
+        }
+        pending.active = false;
+
+        if (pending.seq < seq) {
+            ++mLost;  // Skipped by the peer
+            continue;
+        }
+
+        double rtt = toMs(now - pending.sent);
+        if (!mHasRtt) {
+            mRttMs = rtt;
+            mHasRtt = true;
+        } else {
+            mJitterMs += (std::abs(rtt - mLastRttMs) - mJitterMs) / 16.0;
+            mRttMs += (rtt - mRttMs) / 8.0;
+        }
+        mLastRttMs = rtt;
+        ++mAcked;
+    }
+}
+
+void LinkQuality::received(Clock::time_point now)
+{
+    Clock::duration gap = now - mLastReceived;
+    if (gap > STALL_THRESHOLD) {
+        ++mStalls;
+        mMaxStallMs = std::max(mMaxStallMs, toMs(gap));
+        mLastStall = now;
+        mHasStalled = true;
+    }
+    mLastReceived = std::max(mLastReceived, now);
+}
+
+bool LinkQuality::isDegraded(Clock::time_point now) const
+{
+    if (!mEchoesHeartbeats) {
+        return false;
+    }
+    if (now - mLastReceived > STALL_THRESHOLD) {
+        return true;
+    }
+    if (mHasStalled && now - mLastStall < DEGRADED_HOLD) {
+        return true;
+    }
+    return mHasRtt && (mRttMs > DEGRADED_RTT_MS || mJitterMs > DEGRADED_JITTER_MS);
+}
+
+void LinkQuality::expire(Clock::time_point now)
+{
+    for (Pending &pending : mPending) {
+        if (pending.active && now - pending.sent > DEAD_TIMEOUT) {
+            pending.active = false;
+            ++mLost;
+        }
+    }
+}
+
+} // namespace konflikt
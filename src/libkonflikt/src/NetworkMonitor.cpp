@@ -0,0 +1,117 @@
+#include "konflikt/NetworkMonitor.h"
+
+#ifdef __linux__
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <notify.h>
+#endif
+
+namespace konflikt {
+
+NetworkMonitor::~NetworkMonitor()
+{
+    stop();
+}
+
+#ifdef __linux__
+
+bool NetworkMonitor::start()
+{
+    if (mHandle >= 0) {
+        return true;
+    }
+
+    mHandle = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (mHandle < 0) {
+        return false;
+    }
+
+    sockaddr_nl addr {};
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR | RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE;
+    if (bind(mHandle, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void NetworkMonitor::stop()
+{
+    if (mHandle >= 0) {
+        close(mHandle);
+        mHandle = -1;
+    }
+}
+
+bool NetworkMonitor::poll()
+{
+    if (mHandle < 0) {
+        return false;
+    }
+
+    // Drain everything queued; any notification counts as a change
+    bool changed = false;
+    char buffer[8192];
+    while (recv(mHandle, buffer, sizeof(buffer), 0) > 0) {
+        changed = true;
+    }
+    return changed;
+}
+
+#elif defined(__APPLE__)
+
+bool NetworkMonitor::start()
+{
+    if (mHandle >= 0) {
+        return true;
+    }
+
+    int token = -1;
+    if (notify_register_check("com.apple.system.config.network_change", &token) != NOTIFY_STATUS_OK) {
+        return false;
+    }
+    mHandle = token;
+
+    // The first check always reports a change
+    int check = 0;
+    notify_check(mHandle, &check);
+    return true;
+}
+
+void NetworkMonitor::stop()
+{
+    if (mHandle >= 0) {
+        notify_cancel(mHandle);
+        mHandle = -1;
+    }
+}
+
+bool NetworkMonitor::poll()
+{
+    int check = 0;
+    return mHandle >= 0 && notify_check(mHandle, &check) == NOTIFY_STATUS_OK && check != 0;
+}
+
+#else
+
+bool NetworkMonitor::start()
+{
+    return false;
+}
+
+void NetworkMonitor::stop()
+{
+}
+
+bool NetworkMonitor::poll()
+{
+    return false;
+}
+
+#endif
+
+} // namespace konflikt
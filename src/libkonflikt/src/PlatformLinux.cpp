@@ -3,6 +3,7 @@
 
 #ifndef __APPLE__
 
+#include "konflikt/KeyCodes.h"
 #include "konflikt/Platform.h"
 
 #include <algorithm>
@@ -11,6 +12,8 @@
 #include <cstring>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 // Workaround for xcb/xkb.h using 'explicit' as a struct field name
 // which conflicts with the C++ keyword
@@ -53,15 +56,32 @@ public:
         }
         mScreen = iter.data;
 
+        // Send every startup query before waiting on any reply, so they share
+        // one round trip instead of taking one each. Extension requests first
+        // need the extension's opcode, so look those up the same way.
+        xcb_prefetch_extension_data(mConnection, &xcb_xkb_id);
+        xcb_prefetch_extension_data(mConnection, &xcb_input_id);
+        xcb_prefetch_extension_data(mConnection, &xcb_randr_id);
+        xcb_xkb_use_extension_cookie_t xkbCookie =
+            xcb_xkb_use_extension(mConnection, XCB_XKB_MAJOR_VERSION, XCB_XKB_MINOR_VERSION);
+        xcb_input_xi_query_version_cookie_t xiCookie =
+            xcb_input_xi_query_version(mConnection, XCB_INPUT_MAJOR_VERSION, XCB_INPUT_MINOR_VERSION);
+        xcb_input_xi_query_device_cookie_t deviceCookie = xcb_input_xi_query_device(mConnection, XCB_INPUT_DEVICE_ALL);
+        xcb_randr_get_screen_resources_cookie_t randrCookie = xcb_randr_get_screen_resources(mConnection, mScreen->root);
+
         // Initialize XKB
-        if (!initXkb()) {
+        if (!initXkb(xkbCookie)) {
             mLogger.error("Failed to initialize XKB");
+            xcb_discard_reply(mConnection, xiCookie.sequence);
+            xcb_discard_reply(mConnection, deviceCookie.sequence);
+            xcb_discard_reply(mConnection, randrCookie.sequence);
             return false;
         }
 
         // Initialize XInput2
-        if (!initXInput()) {
+        if (!initXInput(xiCookie, deviceCookie)) {
             mLogger.error("Failed to initialize XInput2");
+            xcb_discard_reply(mConnection, randrCookie.sequence);
             return false;
         }
 
@@ -69,7 +89,16 @@ public:
         createBlankCursor();
 
         // Update desktop info
-        updateDesktopInfo();
+        updateDesktopInfo(randrCookie);
+        mReportedDesktop = getDesktop();
+
+        // Follow monitors being plugged, unplugged, moved or changing mode
+        const xcb_query_extension_reply_t *randr = xcb_get_extension_data(mConnection, &xcb_randr_id);
+        if (randr && randr->present) {
+            xcb_randr_select_input(mConnection, mScreen->root,
+                                   XCB_RANDR_NOTIFY_MASK_SCREEN_CHANGE | XCB_RANDR_NOTIFY_MASK_CRTC_CHANGE);
+            xcb_flush(mConnection);
+        }
 
         return true;
     }
@@ -144,28 +173,9 @@ public:
         } else if (event.type == EventType::MouseScroll) {
             // X11 scroll events are button press/release events
             // Button 4 = scroll up, 5 = scroll down, 6 = scroll left, 7 = scroll right
-            int scrollY = static_cast<int>(event.state.scrollY);
-            int scrollX = static_cast<int>(event.state.scrollX);
-
-            // Vertical scroll
-            if (scrollY != 0) {
-                uint8_t button = scrollY > 0 ? 4 : 5; // 4=up, 5=down
-                int count = std::abs(scrollY);
-                for (int i = 0; i < count; i++) {
-                    xcb_test_fake_input(mConnection, XCB_BUTTON_PRESS, button, XCB_CURRENT_TIME, mScreen->root, 0, 0, 0);
-                    xcb_test_fake_input(mConnection, XCB_BUTTON_RELEASE, button, XCB_CURRENT_TIME, mScreen->root, 0, 0, 0);
-                }
-            }
-
-            // Horizontal scroll
-            if (scrollX != 0) {
-                uint8_t button = scrollX > 0 ? 7 : 6; // 7=right, 6=left
-                int count = std::abs(scrollX);
-                for (int i = 0; i < count; i++) {
-                    xcb_test_fake_input(mConnection, XCB_BUTTON_PRESS, button, XCB_CURRENT_TIME, mScreen->root, 0, 0, 0);
-                    xcb_test_fake_input(mConnection, XCB_BUTTON_RELEASE, button, XCB_CURRENT_TIME, mScreen->root, 0, 0, 0);
-                }
-            }
+            // XTest can only inject whole clicks, so fractional deltas are carried over
+            sendScrollClicks(mScrollRemainderY, event.state.scrollY, 4, 5);
+            sendScrollClicks(mScrollRemainderX, event.state.scrollX, 7, 6);
         } else {
             uint8_t button = 1;
             if (event.button == MouseButton::Right)
@@ -188,15 +198,38 @@ public:
 
     void startListening() override
     {
+        mDesktopOnly = false;
         if (mIsRunning)
             return;
 
         mIsRunning = true;
         mListenerThread = std::thread([this]() {
+            std::string error;
+            if (!applyThreadOptions(mListenerThreadOptions, error)) {
+                mLogger.error("Input thread options: " + error);
+            }
             eventLoop();
         });
     }
 
+    void startWatchingDesktop() override
+    {
+        if (mIsRunning)
+            return;
+
+        // Same thread and event loop; input events are drained but not reported
+        mDesktopOnly = true;
+        mIsRunning = true;
+        mListenerThread = std::thread([this]() {
+            eventLoop();
+        });
+    }
+
+    void setListenerThreadOptions(const ThreadOptions &options) override
+    {
+        mListenerThreadOptions = options;
+    }
+
     void stopListening() override
     {
         if (!mIsRunning)
@@ -300,15 +333,42 @@ public:
     }
 
 private:
-    bool initXkb()
+    /// A smooth-scroll valuator of an XInput device
+    struct ScrollValuator
     {
-        mXkbContext = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
-        if (!mXkbContext)
-            return false;
+        uint16_t number {};
+        bool horizontal {};
+        double increment {};  // Valuator delta for one wheel click
+    };
+
+    static double toDouble(const xcb_input_fp3232_t &value)
+    {
+        return static_cast<double>(value.integral) + static_cast<double>(value.frac) / 4294967296.0;
+    }
 
+    void sendScrollClicks(double &remainder, double delta, uint8_t positiveButton, uint8_t negativeButton)
+    {
+        if (delta == 0)
+            return;
+
+        // Don't let a leftover fraction delay a change of direction
+        if (remainder * delta < 0)
+            remainder = 0;
+
+        remainder += delta;
+        int clicks = static_cast<int>(remainder);
+        remainder -= clicks;
+
+        uint8_t button = clicks > 0 ? positiveButton : negativeButton;
+        for (int i = 0; i < std::abs(clicks); i++) {
+            xcb_test_fake_input(mConnection, XCB_BUTTON_PRESS, button, XCB_CURRENT_TIME, mScreen->root, 0, 0, 0);
+            xcb_test_fake_input(mConnection, XCB_BUTTON_RELEASE, button, XCB_CURRENT_TIME, mScreen->root, 0, 0, 0);
+        }
+    }
+
+    bool initXkb(xcb_xkb_use_extension_cookie_t cookie)
+    {
         // Enable XKB extension
-        xcb_xkb_use_extension_cookie_t cookie =
-            xcb_xkb_use_extension(mConnection, XCB_XKB_MAJOR_VERSION, XCB_XKB_MINOR_VERSION);
         xcb_xkb_use_extension_reply_t *reply = xcb_xkb_use_extension_reply(mConnection, cookie, nullptr);
 
         if (!reply || !reply->supported) {
@@ -317,19 +377,20 @@ private:
         }
         free(reply);
 
-        return true;
+        mXkbContext = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+        return mXkbContext != nullptr;
     }
 
-    bool initXInput()
+    bool initXInput(xcb_input_xi_query_version_cookie_t cookie, xcb_input_xi_query_device_cookie_t deviceCookie)
     {
         // Query XInput extension
-        xcb_input_xi_query_version_cookie_t cookie =
-            xcb_input_xi_query_version(mConnection, XCB_INPUT_MAJOR_VERSION, XCB_INPUT_MINOR_VERSION);
         xcb_input_xi_query_version_reply_t *reply =
             xcb_input_xi_query_version_reply(mConnection, cookie, nullptr);
 
-        if (!reply)
+        if (!reply) {
+            xcb_discard_reply(mConnection, deviceCookie.sequence);
             return false;
+        }
         free(reply);
 
         // Select events on root window
@@ -346,11 +407,48 @@ private:
             XCB_INPUT_XI_EVENT_MASK_RAW_KEY_RELEASE;
 
         xcb_input_xi_select_events(mConnection, mScreen->root, 1, &mask.header);
+
+        // Device (un)plugs change which valuators report smooth scrolling
+        mask.header.deviceid = XCB_INPUT_DEVICE_ALL;
+        mask.mask = XCB_INPUT_XI_EVENT_MASK_HIERARCHY | XCB_INPUT_XI_EVENT_MASK_DEVICE_CHANGED;
+        xcb_input_xi_select_events(mConnection, mScreen->root, 1, &mask.header);
         xcb_flush(mConnection);
 
+        updateScrollValuators(deviceCookie);
+
         return true;
     }
 
+    void updateScrollValuators()
+    {
+        updateScrollValuators(xcb_input_xi_query_device(mConnection, XCB_INPUT_DEVICE_ALL));
+    }
+
+    void updateScrollValuators(xcb_input_xi_query_device_cookie_t cookie)
+    {
+        mScrollValuators.clear();
+
+        xcb_input_xi_query_device_reply_t *reply = xcb_input_xi_query_device_reply(mConnection, cookie, nullptr);
+        if (!reply)
+            return;
+
+        for (auto device = xcb_input_xi_query_device_infos_iterator(reply); device.rem; xcb_input_xi_device_info_next(&device)) {
+            for (auto cls = xcb_input_xi_device_info_classes_iterator(device.data); cls.rem; xcb_input_device_class_next(&cls)) {
+                if (cls.data->type != XCB_INPUT_DEVICE_CLASS_TYPE_SCROLL)
+                    continue;
+
+                auto *scroll = reinterpret_cast<xcb_input_scroll_class_t *>(cls.data);
+                double increment = toDouble(scroll->increment);
+                if (increment == 0)
+                    continue;
+
+                mScrollValuators[device.data->deviceid].push_back(
+                    { scroll->number, scroll->scroll_type == XCB_INPUT_SCROLL_TYPE_HORIZONTAL, increment });
+            }
+        }
+        free(reply);
+    }
+
     void createBlankCursor()
     {
         xcb_pixmap_t pixmap = xcb_generate_id(mConnection);
@@ -362,12 +460,15 @@ private:
     }
 
     void updateDesktopInfo()
+    {
+        updateDesktopInfo(xcb_randr_get_screen_resources(mConnection, mScreen->root));
+    }
+
+    void updateDesktopInfo(xcb_randr_get_screen_resources_cookie_t resCookie)
     {
         Desktop newDesktop;
 
         // Get screen dimensions using RANDR
-        xcb_randr_get_screen_resources_cookie_t resCookie =
-            xcb_randr_get_screen_resources(mConnection, mScreen->root);
         xcb_randr_get_screen_resources_reply_t *resources =
             xcb_randr_get_screen_resources_reply(mConnection, resCookie, nullptr);
 
@@ -375,14 +476,15 @@ private:
             xcb_randr_crtc_t *crtcs = xcb_randr_get_screen_resources_crtcs(resources);
             int numCrtcs = xcb_randr_get_screen_resources_crtcs_length(resources);
 
-            int32_t minX = 0, minY = 0, maxX = 0, maxY = 0;
-            bool first = true;
+            // Ask for every CRTC before waiting on the first reply
+            std::vector<xcb_randr_get_crtc_info_cookie_t> crtcCookies(numCrtcs);
+            for (int i = 0; i < numCrtcs; i++) {
+                crtcCookies[i] = xcb_randr_get_crtc_info(mConnection, crtcs[i], resources->config_timestamp);
+            }
 
             for (int i = 0; i < numCrtcs; i++) {
-                xcb_randr_get_crtc_info_cookie_t crtcCookie =
-                    xcb_randr_get_crtc_info(mConnection, crtcs[i], resources->config_timestamp);
                 xcb_randr_get_crtc_info_reply_t *crtcInfo =
-                    xcb_randr_get_crtc_info_reply(mConnection, crtcCookie, nullptr);
+                    xcb_randr_get_crtc_info_reply(mConnection, crtcCookies[i], nullptr);
 
                 if (crtcInfo && crtcInfo->width > 0 && crtcInfo->height > 0) {
                     Display display;
@@ -394,25 +496,11 @@ private:
                     display.isPrimary = (i == 0);
 
                     newDesktop.displays.push_back(display);
-
-                    if (first) {
-                        minX = display.x;
-                        minY = display.y;
-                        maxX = display.x + display.width;
-                        maxY = display.y + display.height;
-                        first = false;
-                    } else {
-                        minX = std::min(minX, display.x);
-                        minY = std::min(minY, display.y);
-                        maxX = std::max(maxX, display.x + display.width);
-                        maxY = std::max(maxY, display.y + display.height);
-                    }
                 }
                 free(crtcInfo);
             }
 
-            newDesktop.width = maxX - minX;
-            newDesktop.height = maxY - minY;
+            updateDesktopBounds(newDesktop);
 
             free(resources);
         } else {
@@ -434,15 +522,110 @@ private:
         mCurrentDesktop = newDesktop;
     }
 
+    static void updateDesktopBounds(Desktop &desktop)
+    {
+        int32_t minX = 0, minY = 0, maxX = 0, maxY = 0;
+        bool first = true;
+        for (const Display &display : desktop.displays) {
+            if (first) {
+                minX = display.x;
+                minY = display.y;
+                maxX = display.x + display.width;
+                maxY = display.y + display.height;
+                first = false;
+            } else {
+                minX = std::min(minX, display.x);
+                minY = std::min(minY, display.y);
+                maxX = std::max(maxX, display.x + display.width);
+                maxY = std::max(maxY, display.y + display.height);
+            }
+        }
+        desktop.width = maxX - minX;
+        desktop.height = maxY - minY;
+    }
+
+    // Apply a CRTC change notification without querying the server
+    void applyCrtcChange(const xcb_randr_crtc_change_t &change)
+    {
+        std::lock_guard<std::mutex> lock(mDesktopMutex);
+        std::vector<Display> &displays = mCurrentDesktop.displays;
+        auto it = std::find_if(displays.begin(), displays.end(), [&](const Display &display) {
+            return display.id == change.crtc;
+        });
+
+        if (change.mode == XCB_NONE || change.width == 0 || change.height == 0) {
+            // Disabled (e.g. monitor unplugged)
+            if (it != displays.end()) {
+                bool wasPrimary = it->isPrimary;
+                displays.erase(it);
+                if (wasPrimary && !displays.empty()) {
+                    displays.front().isPrimary = true;
+                }
+            }
+        } else {
+            if (it == displays.end()) {
+                Display display;
+                display.id = change.crtc;
+                display.isPrimary = displays.empty();
+                it = displays.insert(displays.end(), display);
+            }
+            it->x = change.x;
+            it->y = change.y;
+            it->width = change.width;
+            it->height = change.height;
+        }
+
+        updateDesktopBounds(mCurrentDesktop);
+    }
+
+    // Listener thread: report the desktop if it differs from what was last reported
+    void reportDesktopChange(bool rescan)
+    {
+        if (rescan) {
+            updateDesktopInfo();
+        }
+
+        Desktop desktop = getDesktop();
+        if (desktop == mReportedDesktop) {
+            return;
+        }
+        mReportedDesktop = desktop;
+
+        mLogger.debug("Desktop changed: " + std::to_string(desktop.displays.size()) + " displays, " +
+                      std::to_string(desktop.width) + "x" + std::to_string(desktop.height));
+
+        Event event {};
+        event.type = EventType::DesktopChanged;
+        event.timestamp = timestamp();
+        event.state = getState();
+        if (onEvent)
+            onEvent(event);
+    }
+
     void eventLoop()
     {
         // Get XInput opcode
         const xcb_query_extension_reply_t *extReply = xcb_get_extension_data(mConnection, &xcb_input_id);
         uint8_t xiOpcode = extReply ? extReply->major_opcode : 0;
 
+        // RandR events are numbered from the extension's first event
+        const xcb_query_extension_reply_t *randrReply = xcb_get_extension_data(mConnection, &xcb_randr_id);
+        uint8_t randrEventBase = randrReply && randrReply->present ? randrReply->first_event : 0;
+
+        // A reconfiguration arrives as a burst of notifications; report it once
+        // the burst has been drained
+        bool desktopDirty = false;
+        bool desktopRescan = false;
+
         while (mIsRunning) {
             xcb_generic_event_t *xcbEvent = xcb_poll_for_event(mConnection);
             if (!xcbEvent) {
+                if (desktopDirty) {
+                    reportDesktopChange(desktopRescan);
+                    desktopDirty = false;
+                    desktopRescan = false;
+                    continue;
+                }
                 std::this_thread::sleep_for(std::chrono::milliseconds(1));
                 continue;
             }
@@ -451,9 +634,19 @@ private:
 
             if (responseType == XCB_GE_GENERIC && xiOpcode) {
                 auto *ge = reinterpret_cast<xcb_ge_generic_event_t *>(xcbEvent);
-                if (ge->extension == xiOpcode) {
+                if (ge->extension == xiOpcode && !mDesktopOnly) {
                     handleXInputEvent(ge);
                 }
+            } else if (randrEventBase && responseType == randrEventBase + XCB_RANDR_NOTIFY) {
+                auto *notify = reinterpret_cast<xcb_randr_notify_event_t *>(xcbEvent);
+                if (notify->subCode == XCB_RANDR_NOTIFY_CRTC_CHANGE) {
+                    applyCrtcChange(notify->u.cc);
+                    desktopDirty = true;
+                }
+            } else if (randrEventBase && responseType == randrEventBase + XCB_RANDR_SCREEN_CHANGE_NOTIFY) {
+                // The root window was resized; requery so nothing is missed
+                desktopDirty = true;
+                desktopRescan = true;
             }
 
             free(xcbEvent);
@@ -466,23 +659,77 @@ private:
         event.timestamp = timestamp();
 
         switch (ge->event_type) {
-            case XCB_INPUT_RAW_MOTION: {
-                auto *raw = reinterpret_cast<xcb_input_raw_motion_event_t *>(ge);
-                event.type = EventType::MouseMove;
+            case XCB_INPUT_HIERARCHY:
+            case XCB_INPUT_DEVICE_CHANGED:
+                updateScrollValuators();
+                break;
 
-            // Get axis values for delta
-                xcb_input_fp3232_t *values = xcb_input_raw_button_press_axisvalues_raw(
-                    reinterpret_cast<xcb_input_raw_button_press_event_t *>(raw));
+            case XCB_INPUT_RAW_MOTION: {
+                auto *raw = reinterpret_cast<xcb_input_raw_button_press_event_t *>(ge);
 
-                int numValues =
-                    xcb_input_raw_button_press_axisvalues_raw_length(reinterpret_cast<xcb_input_raw_button_press_event_t *>(raw));
+                // Raw events only carry the valuators set in the mask, in valuator order
+                const uint32_t *valuatorMask = xcb_input_raw_button_press_valuator_mask(raw);
+                int maskLength = xcb_input_raw_button_press_valuator_mask_length(raw);
+                const xcb_input_fp3232_t *values = xcb_input_raw_button_press_axisvalues(raw);
+                const xcb_input_fp3232_t *rawValues = xcb_input_raw_button_press_axisvalues_raw(raw);
+
+                auto scrollIt = mScrollValuators.find(raw->sourceid);
+                bool emulated = (raw->flags & XCB_INPUT_POINTER_EVENT_FLAGS_POINTER_EMULATED) != 0;
+                bool moved = false;
+                bool scrolled = false;
+                double scrollX = 0;
+                double scrollY = 0;
+                int index = 0;
+
+                for (int word = 0; word < maskLength; ++word) {
+                    for (uint16_t bit = 0; bit < 32; ++bit) {
+                        if (!(valuatorMask[word] & (1u << bit)))
+                            continue;
+
+                        uint16_t number = static_cast<uint16_t>(word * 32 + bit);
+                        const int valueIndex = index++;
+                        if (number == 0 || number == 1) {
+                            (number == 0 ? event.state.dx : event.state.dy) = rawValues[valueIndex].integral;
+                            moved = true;
+                            continue;
+                        }
+
+                        // Wheel clicks are reported again as emulated valuator motion; count them once
+                        if (emulated || scrollIt == mScrollValuators.end())
+                            continue;
+
+                        for (const ScrollValuator &valuator : scrollIt->second) {
+                            if (valuator.number != number)
+                                continue;
+
+                            // Valuators grow down/right; scrollY is positive for up
+                            double clicks = toDouble(values[valueIndex]) / valuator.increment;
+                            if (valuator.horizontal)
+                                scrollX += clicks;
+                            else
+                                scrollY -= clicks;
+                            scrolled = true;
+                        }
+                    }
+                }
 
-                if (numValues >= 2) {
-                    event.state.dx = static_cast<int32_t>(values[0].integral);
-                    event.state.dy = static_cast<int32_t>(values[1].integral);
+                if (scrolled) {
+                    Event scroll;
+                    scroll.type = EventType::MouseScroll;
+                    scroll.timestamp = event.timestamp;
+                    scroll.state = getState();
+                    scroll.state.scrollX = scrollX;
+                    scroll.state.scrollY = scrollY;
+                    if (onEvent)
+                        onEvent(scroll);
                 }
 
-            // Get current position
+                if (!moved && scrolled)
+                    break;
+
+                event.type = EventType::MouseMove;
+
+                // Get current position
                 InputState state = getState();
                 event.state.x = state.x;
                 event.state.y = state.y;
@@ -505,6 +752,10 @@ private:
                     if (!isPress)
                         break; // Ignore release events for scroll
 
+                    // Emulated from smooth-scroll valuators, which were already reported
+                    if (raw->flags & XCB_INPUT_POINTER_EVENT_FLAGS_POINTER_EMULATED)
+                        break;
+
                     event.type = EventType::MouseScroll;
                     event.state = getState();
 
@@ -552,6 +803,7 @@ private:
                 auto *raw = reinterpret_cast<xcb_input_raw_key_press_event_t *>(ge);
                 event.type = ge->event_type == XCB_INPUT_RAW_KEY_PRESS ? EventType::KeyPress : EventType::KeyRelease;
                 event.keycode = raw->detail - 8; // Convert to Linux keycode
+                event.hidUsage = hidUsageFromEvdev(event.keycode);
 
                 event.state = getState();
                 if (onEvent)
@@ -568,11 +820,21 @@ private:
 
     xkb_context *mXkbContext { nullptr };
 
+    // Listener thread only: smooth-scroll valuators by device id
+    std::unordered_map<uint16_t, std::vector<ScrollValuator>> mScrollValuators;
+
+    // Fraction of a wheel click not yet injected
+    double mScrollRemainderX { 0 };
+    double mScrollRemainderY { 0 };
+
     Logger mLogger;
     mutable std::mutex mDesktopMutex;
     Desktop mCurrentDesktop;
+    Desktop mReportedDesktop;
+    std::atomic<bool> mDesktopOnly { false };  // startWatchingDesktop(): no input events  // Listener thread: last desktop sent as DesktopChanged
 
     std::thread mListenerThread;
+    ThreadOptions mListenerThreadOptions;
     std::atomic<bool> mIsRunning { false };
     bool mCursorVisible { true };
 };
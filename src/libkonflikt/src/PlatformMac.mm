@@ -2,6 +2,7 @@
 
 #ifdef __APPLE__
 
+#include "konflikt/KeyCodes.h"
 #include "konflikt/Platform.h"
 
 #include <ApplicationServices/ApplicationServices.h>
@@ -166,12 +167,15 @@ public:
                 break;
             }
             case EventType::MouseScroll: {
-                // Create scroll wheel event
-                // wheelCount=2 for both axes, units are in "lines"
-                cgEvent = CGEventCreateScrollWheelEvent(
-                    source, kCGScrollEventUnitPixel, 2,
-                    static_cast<int32_t>(event.state.scrollY),
-                    static_cast<int32_t>(event.state.scrollX));
+                // Deltas arrive in wheel clicks (fractional for smooth scrolling); post them as
+                // pixels so small deltas aren't lost, carrying the sub-pixel part over
+                int32_t pixelsY = takeScrollPixels(mScrollRemainderY, event.state.scrollY);
+                int32_t pixelsX = takeScrollPixels(mScrollRemainderX, event.state.scrollX);
+                if (pixelsX == 0 && pixelsY == 0)
+                    break;
+
+                // wheelCount=2 for both axes
+                cgEvent = CGEventCreateScrollWheelEvent(source, kCGScrollEventUnitPixel, 2, pixelsY, pixelsX);
                 break;
             }
             default:
@@ -211,10 +215,25 @@ public:
 
         // Start event tap in a separate thread
         mListenerThread = std::thread([this]() {
+            std::string error;
+            if (!applyThreadOptions(mListenerThreadOptions, error)) {
+                mLogger.error("Input thread options: " + error);
+            }
             runEventLoop();
         });
     }
 
+    void startWatchingDesktop() override
+    {
+        // The display reconfiguration callback registered in initialize()
+        // already reports DesktopChanged; no event tap needed
+    }
+
+    void setListenerThreadOptions(const ThreadOptions &options) override
+    {
+        mListenerThreadOptions = options;
+    }
+
     void stopListening() override
     {
         if (!mIsRunning) {
@@ -291,6 +310,20 @@ public:
     }
 
 private:
+    /// Pixels posted per wheel click
+    static constexpr double SCROLL_PIXELS_PER_CLICK = 10.0;
+
+    static int32_t takeScrollPixels(double &remainder, double clicks)
+    {
+        if (remainder * clicks < 0)
+            remainder = 0;
+
+        remainder += clicks * SCROLL_PIXELS_PER_CLICK;
+        auto pixels = static_cast<int32_t>(remainder);
+        remainder -= pixels;
+        return pixels;
+    }
+
     static void displayConfigurationCallback(
         CGDirectDisplayID /*display*/,
         CGDisplayChangeSummaryFlags flags,
@@ -468,13 +501,14 @@ private:
             case kCGEventKeyDown: {
                 event.type = EventType::KeyPress;
                 event.keycode = static_cast<uint32_t>(CGEventGetIntegerValueField(cgEvent, kCGKeyboardEventKeycode));
+                event.hidUsage = hidUsageFromMac(event.keycode);
 
                 // Try to get the text representation
                 UniChar chars[4];
                 UniCharCount length = 0;
                 CGEventKeyboardGetUnicodeString(cgEvent, 4, &length, chars);
                 if (length > 0) {
-                    event.text = std::string(reinterpret_cast<char *>(chars), length * sizeof(UniChar));
+                    event.text.assignUtf16(reinterpret_cast<const char16_t *>(chars), length);
                 }
 
                 platform->onEvent(event);
@@ -484,13 +518,14 @@ private:
             case kCGEventKeyUp: {
                 event.type = EventType::KeyRelease;
                 event.keycode = static_cast<uint32_t>(CGEventGetIntegerValueField(cgEvent, kCGKeyboardEventKeycode));
+                event.hidUsage = hidUsageFromMac(event.keycode);
 
                 // Try to get the text representation
                 UniChar chars[4];
                 UniCharCount length = 0;
                 CGEventKeyboardGetUnicodeString(cgEvent, 4, &length, chars);
                 if (length > 0) {
-                    event.text = std::string(reinterpret_cast<char *>(chars), length * sizeof(UniChar));
+                    event.text.assignUtf16(reinterpret_cast<const char16_t *>(chars), length);
                 }
 
                 platform->onEvent(event);
@@ -546,10 +581,15 @@ private:
     CFRunLoopSourceRef mRunLoopSource { nullptr };
     CFRunLoopRef mEventLoop { nullptr };
     std::thread mListenerThread;
+    ThreadOptions mListenerThreadOptions;
     std::atomic<bool> mIsRunning { false };
     Logger mLogger;
     bool mCursorVisible { true };
 
+    // Fraction of a pixel not yet posted
+    double mScrollRemainderX { 0 };
+    double mScrollRemainderY { 0 };
+
     // Desktop change monitoring
     mutable std::mutex mDesktopMutex;
     Desktop mCurrentDesktop;
@@ -0,0 +1,163 @@
+#include "konflikt/PointerMotion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace konflikt {
+
+namespace {
+
+/// Gaps longer than this are treated as the pointer having stopped
+constexpr double IDLE_MS = 50.0;
+
+/// Shortest interval used for velocity, so same-timestamp events don't spike it
+constexpr double MIN_INTERVAL_MS = 0.125;
+
+/// How often the transit-time estimate is refreshed
+constexpr auto OFFSET_WINDOW = std::chrono::seconds(2);
+
+int64_t toMicroseconds(MotionJitterBuffer::Clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
+void PointerAccelerator::apply(const PointerCurve &curve, int32_t &dx, int32_t &dy, Clock::time_point now)
+{
+    double elapsedMs = std::chrono::duration<double, std::milli>(now - mLastMotion).count();
+    mLastMotion = now;
+
+    double distance = std::hypot(static_cast<double>(dx), static_cast<double>(dy));
+    double instant = distance / std::clamp(elapsedMs, MIN_INTERVAL_MS, IDLE_MS);
+    mVelocity = elapsedMs >= IDLE_MS ? instant : (mVelocity + instant) / 2.0;
+
+    double gain = 1.0 + curve.acceleration * std::max(0.0, mVelocity - curve.threshold);
+    gain = curve.speed * std::min(gain, MAX_GAIN);
+
+    double x = dx * gain + mRemainderX;
+    double y = dy * gain + mRemainderY;
+    dx = static_cast<int32_t>(x);
+    dy = static_cast<int32_t>(y);
+    mRemainderX = x - dx;
+    mRemainderY = y - dy;
+}
+
+void PointerAccelerator::reset()
+{
+    mLastMotion = {};
+    mVelocity = 0.0;
+    mRemainderX = 0.0;
+    mRemainderY = 0.0;
+}
+
+MotionJitterBuffer::MotionJitterBuffer(std::chrono::microseconds target, Playout playout)
+    : mTarget(target)
+    , mPlayout(std::move(playout))
+    , mThread([this]() { run(); })
+{
+}
+
+MotionJitterBuffer::~MotionJitterBuffer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mCondition.notify_one();
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+}
+
+void MotionJitterBuffer::push(const Event &event, uint64_t sentNs)
+{
+    Clock::time_point now = Clock::now();
+    // Only differences matter, so the sender's clock epoch doesn't
+    int64_t sentUs = sentNs != 0 ? static_cast<int64_t>(sentNs / 1000) : static_cast<int64_t>(event.timestamp) * 1000;
+    int64_t offsetUs = toMicroseconds(now) - sentUs;
+
+    std::lock_guard<std::mutex> playout(mPlayoutMutex);
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    if (!mHasOffset || now - mWindowStart >= OFFSET_WINDOW) {
+        mOffsetUs = mHasOffset ? std::min(mWindowOffsetUs, offsetUs) : offsetUs;
+        mWindowOffsetUs = offsetUs;
+        mWindowStart = now;
+        mHasOffset = true;
+    }
+    mOffsetUs = std::min(mOffsetUs, offsetUs);
+    mWindowOffsetUs = std::min(mWindowOffsetUs, offsetUs);
+
+    // Packets that took the fastest path wait the full target; late ones wait less
+    Clock::time_point due = now + mTarget - std::chrono::microseconds(offsetUs - mOffsetUs);
+
+    if (due <= now && mQueue.empty()) {
+        lock.unlock();
+        mPlayout(event);
+        return;
+    }
+
+    mQueue.push_back({ std::max(due, now), event });
+    lock.unlock();
+    mCondition.notify_one();
+}
+
+void MotionJitterBuffer::flush()
+{
+    std::lock_guard<std::mutex> playout(mPlayoutMutex);
+    playDue(Clock::time_point::max());
+}
+
+void MotionJitterBuffer::clear()
+{
+    // Waits out a batch being played, so nothing from it lands afterwards
+    std::lock_guard<std::mutex> playout(mPlayoutMutex);
+    std::lock_guard<std::mutex> lock(mMutex);
+    mQueue.clear();
+    mHasOffset = false;
+}
+
+void MotionJitterBuffer::playDue(Clock::time_point now)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        while (!mQueue.empty() && mQueue.front().due <= now) {
+            mBatch.push_back(std::move(mQueue.front().event));
+            mQueue.pop_front();
+        }
+    }
+
+    for (const Event &event : mBatch) {
+        mPlayout(event);
+    }
+    mDelayedSamples += mBatch.size();
+    mBatch.clear();
+}
+
+void MotionJitterBuffer::run()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (!mStopping) {
+        if (mQueue.empty()) {
+            mCondition.wait(lock);
+            continue;
+        }
+
+        Clock::time_point due = mQueue.front().due;
+        if (Clock::now() < due) {
+            mCondition.wait_until(lock, due);
+            continue;
+        }
+
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> playout(mPlayoutMutex);
+            playDue(Clock::now());
+        }
+        lock.lock();
+    }
+}
+
+} // namespace konflikt
@@ -1,4 +1,5 @@
 #include "konflikt/Protocol.h"
+#include "konflikt/Platform.h"
 
 #include <glaze/glaze.hpp>
 
@@ -32,4 +33,29 @@ std::optional<std::string> getMessageType(std::string_view json)
     return result.type;
 }
 
+bool fromJson(std::string_view json, InputEventMessage &result)
+{
+    // Optional fields are omitted from the JSON, so without this a stale source
+    // or button would carry over. The strings keep their capacity.
+    result.source = NO_INSTANCE;
+    result.sourceInstanceId.reset();
+    result.eventType.clear();
+    std::string button = std::move(result.eventData.button);
+    button.clear();
+    result.eventData = InputEventData {};
+    result.eventData.button = std::move(button);
+    return !glz::read_json(result, json);
+}
+
+std::string_view InputEventEncoder::encode(std::string_view eventType, const InputEventData &data)
+{
+    mMessage.eventType.assign(eventType);
+    mMessage.eventData = data;
+    mMessage.eventData.sentNs = monotonicNs();
+    if (!toJson(mMessage, mBuffer)) {
+        return {};
+    }
+    return mBuffer;
+}
+
 } // namespace konflikt
@@ -0,0 +1,116 @@
+#include "konflikt/ServerCache.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace konflikt {
+
+namespace {
+
+bool betterThan(const CachedServer &a, const CachedServer &b)
+{
+    // Unmeasured RTT sorts after any measured one
+    auto key = [](const CachedServer &server) {
+        return std::make_tuple(server.failures,
+                               server.lastConnected == 0,
+                               server.rttMs < 0,
+                               server.rttMs,
+                               ~server.lastSeen);
+    };
+    return key(a) < key(b);
+}
+
+} // namespace
+
+void ServerCache::assign(std::vector<CachedServer> servers, uint64_t now)
+{
+    mServers = std::move(servers);
+    std::erase_if(mServers, [](const CachedServer &server) {
+        return server.host.empty() || server.port <= 0;
+    });
+    prune(now);
+}
+
+bool ServerCache::seen(const DiscoveredService &service, uint64_t now)
+{
+    size_t count = mServers.size();
+    CachedServer &server = entry({ service.host, service.port });
+    bool added = mServers.size() != count;
+
+    server.name = service.name;
+    server.instanceId = service.instanceId;
+    server.lastSeen = now;
+    prune(now);
+    return added;
+}
+
+void ServerCache::connected(const ServerEndpoint &endpoint, double rttMs, uint64_t now)
+{
+    CachedServer &server = entry(endpoint);
+    server.lastSeen = now;
+    server.lastConnected = now;
+    server.failures = 0;
+    if (rttMs >= 0) {
+        server.rttMs = server.rttMs < 0 ? rttMs : server.rttMs + (rttMs - server.rttMs) / 4.0;
+    }
+    prune(now);
+}
+
+void ServerCache::failed(const ServerEndpoint &endpoint)
+{
+    auto it = std::find_if(mServers.begin(), mServers.end(), [&](const CachedServer &server) {
+        return server.endpoint() == endpoint;
+    });
+    if (it != mServers.end()) {
+        ++it->failures;
+    }
+}
+
+std::optional<ServerEndpoint> ServerCache::best() const
+{
+    auto it = std::min_element(mServers.begin(), mServers.end(), betterThan);
+    if (it == mServers.end()) {
+        return std::nullopt;
+    }
+    return it->endpoint();
+}
+
+std::vector<CachedServer> ServerCache::ranked() const
+{
+    std::vector<CachedServer> result = mServers;
+    std::sort(result.begin(), result.end(), betterThan);
+    return result;
+}
+
+CachedServer &ServerCache::entry(const ServerEndpoint &endpoint)
+{
+    auto it = std::find_if(mServers.begin(), mServers.end(), [&](const CachedServer &server) {
+        return server.endpoint() == endpoint;
+    });
+    if (it != mServers.end()) {
+        return *it;
+    }
+
+    CachedServer server;
+    server.host = endpoint.host;
+    server.port = endpoint.port;
+    mServers.push_back(std::move(server));
+    return mServers.back();
+}
+
+void ServerCache::prune(uint64_t now)
+{
+    std::erase_if(mServers, [now](const CachedServer &server) {
+        return server.lastSeen + MAX_AGE_MS < now;
+    });
+
+    // Keep the most recently seen
+    if (mServers.size() > MAX_ENTRIES) {
+        std::sort(mServers.begin(), mServers.end(), [](const CachedServer &a, const CachedServer &b) {
+            return a.lastSeen > b.lastSeen;
+        });
+        mServers.resize(MAX_ENTRIES);
+    }
+}
+
+} // namespace konflikt
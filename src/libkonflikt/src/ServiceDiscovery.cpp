@@ -0,0 +1,83 @@
+// TXT record format shared by the Avahi and Bonjour implementations
+
+#include "konflikt/ServiceDiscovery.h"
+
+#include <charconv>
+
+namespace konflikt {
+
+namespace {
+
+int parseInt(const std::string &value)
+{
+    int result = 0;
+    std::from_chars(value.data(), value.data() + value.size(), result);
+    return result;
+}
+
+} // namespace
+
+std::vector<std::string> serviceTxtEntries(const std::string &instanceId, const ServiceInfo &info)
+{
+    // Each entry must stay under 255 bytes
+    std::string caps;
+    for (const std::string &capability : info.capabilities) {
+        if (!caps.empty()) {
+            caps += ',';
+        }
+        caps += capability;
+    }
+
+    std::vector<std::string> entries = {
+        "id=" + instanceId,
+        "ver=" + info.version,
+        "tls=" + std::string(info.tls ? "1" : "0"),
+        "caps=" + caps,
+        "clients=" + std::to_string(info.clients),
+        "max=" + std::to_string(info.maxClients),
+    };
+    if (!info.commit.empty()) {
+        entries.push_back("commit=" + info.commit);
+    }
+    return entries;
+}
+
+void parseServiceTxtEntry(const std::string &key, const std::string &value, DiscoveredService &service)
+{
+    if (key == "id") {
+        service.instanceId = value;
+        return;
+    }
+
+    if (key != "ver" && key != "commit" && key != "tls" && key != "caps" && key != "clients" && key != "max") {
+        return;
+    }
+
+    ServiceInfo &info = service.info ? *service.info : service.info.emplace();
+    if (key == "ver") {
+        info.version = value;
+    } else if (key == "commit") {
+        info.commit = value;
+    } else if (key == "tls") {
+        info.tls = value == "1";
+    } else if (key == "caps") {
+        info.capabilities.clear();
+        size_t start = 0;
+        while (start < value.size()) {
+            size_t end = value.find(',', start);
+            if (end == std::string::npos) {
+                end = value.size();
+            }
+            if (end > start) {
+                info.capabilities.push_back(value.substr(start, end - start));
+            }
+            start = end + 1;
+        }
+    } else if (key == "clients") {
+        info.clients = parseInt(value);
+    } else if (key == "max") {
+        info.maxClients = parseInt(value);
+    }
+}
+
+} // namespace konflikt
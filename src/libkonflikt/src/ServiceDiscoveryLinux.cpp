@@ -41,10 +41,40 @@ struct ServiceDiscovery::Impl
     std::string registeredName;
     int registeredPort { 0 };
     std::string registeredInstanceId;
+    ServiceInfo registeredInfo;
 
     // Parent pointer for callbacks
     ServiceDiscovery *parent { nullptr };
 
+    // TXT record for the registered service; free with avahi_string_list_free
+    AvahiStringList *makeTxt() const
+    {
+        AvahiStringList *txt = nullptr;
+        for (const std::string &entry : serviceTxtEntries(registeredInstanceId, registeredInfo)) {
+            txt = avahi_string_list_add(txt, entry.c_str());
+        }
+        return txt;
+    }
+
+    // Add the registered service to entryGroup; returns an Avahi error code
+    int addService()
+    {
+        AvahiStringList *txt = makeTxt();
+        int ret = avahi_entry_group_add_service_strlst(
+            entryGroup,
+            AVAHI_IF_UNSPEC,
+            AVAHI_PROTO_UNSPEC,
+            static_cast<AvahiPublishFlags>(0),
+            registeredName.c_str(),
+            kServiceType,
+            nullptr,  // domain
+            nullptr,  // host
+            static_cast<uint16_t>(registeredPort),
+            txt);
+        avahi_string_list_free(txt);
+        return ret;
+    }
+
     // Make unique key for service
     static std::string makeKey(const char *name, const char *type, const char *domain)
     {
@@ -107,22 +137,7 @@ void ServiceDiscovery::Impl::onClientStateChange(AvahiClientState state)
             if (!registeredName.empty() && !entryGroup && client) {
                 entryGroup = avahi_entry_group_new(client, entryGroupCallback, this);
                 if (entryGroup) {
-                    // Create TXT record with instance ID
-                    std::string txtRecord = "id=" + registeredInstanceId;
-
-                    int ret = avahi_entry_group_add_service(
-                        entryGroup,
-                        AVAHI_IF_UNSPEC,
-                        AVAHI_PROTO_UNSPEC,
-                        static_cast<AvahiPublishFlags>(0),
-                        registeredName.c_str(),
-                        kServiceType,
-                        nullptr,  // domain
-                        nullptr,  // host
-                        static_cast<uint16_t>(registeredPort),
-                        txtRecord.c_str(),
-                        nullptr);
-
+                    int ret = addService();
                     if (ret < 0) {
                         if (parent->mCallbacks.onError) {
                             parent->mCallbacks.onError("Failed to add service: " + std::string(avahi_strerror(ret)));
@@ -264,26 +279,24 @@ void ServiceDiscovery::Impl::onResolveResult(AvahiIfIndex interface, AvahiProtoc
 
     switch (event) {
         case AVAHI_RESOLVER_FOUND: {
-            // Parse TXT record for instance ID
-            std::string instanceId;
+            DiscoveredService service;
+            service.name = name;
+            service.host = hostName;
+            service.port = port;
+
+            // Parse TXT record for instance ID, version, capabilities and load
             for (AvahiStringList *l = txt; l; l = avahi_string_list_get_next(l)) {
                 char *k = nullptr;
                 char *v = nullptr;
                 if (avahi_string_list_get_pair(l, &k, &v, nullptr) >= 0) {
-                    if (k && v && std::string(k) == "id") {
-                        instanceId = v;
+                    if (k && v) {
+                        parseServiceTxtEntry(k, v, service);
                     }
                     avahi_free(k);
                     avahi_free(v);
                 }
             }
 
-            DiscoveredService service;
-            service.name = name;
-            service.host = hostName;
-            service.port = port;
-            service.instanceId = instanceId;
-
             {
                 std::lock_guard<std::mutex> lock(mutex);
                 services[name] = service;
@@ -373,7 +386,8 @@ void ServiceDiscovery::setCallbacks(ServiceDiscoveryCallbacks callbacks)
     mCallbacks = std::move(callbacks);
 }
 
-bool ServiceDiscovery::registerService(const std::string &name, int port, const std::string &instanceId)
+bool ServiceDiscovery::registerService(const std::string &name, int port, const std::string &instanceId,
+                                       const ServiceInfo &info)
 {
     if (!mImpl->client) {
         if (mCallbacks.onError) {
@@ -391,26 +405,13 @@ bool ServiceDiscovery::registerService(const std::string &name, int port, const
     mImpl->registeredName = name;
     mImpl->registeredPort = port;
     mImpl->registeredInstanceId = instanceId;
+    mImpl->registeredInfo = info;
 
     // If client is already running, create entry group now
     if (avahi_client_get_state(mImpl->client) == AVAHI_CLIENT_S_RUNNING) {
         mImpl->entryGroup = avahi_entry_group_new(mImpl->client, entryGroupCallback, mImpl.get());
         if (mImpl->entryGroup) {
-            std::string txtRecord = "id=" + instanceId;
-
-            int ret = avahi_entry_group_add_service(
-                mImpl->entryGroup,
-                AVAHI_IF_UNSPEC,
-                AVAHI_PROTO_UNSPEC,
-                static_cast<AvahiPublishFlags>(0),
-                name.c_str(),
-                kServiceType,
-                nullptr,
-                nullptr,
-                static_cast<uint16_t>(port),
-                txtRecord.c_str(),
-                nullptr);
-
+            int ret = mImpl->addService();
             if (ret < 0) {
                 avahi_threaded_poll_unlock(mImpl->threadedPoll);
                 if (mCallbacks.onError) {
@@ -427,6 +428,31 @@ bool ServiceDiscovery::registerService(const std::string &name, int port, const
     return true;
 }
 
+void ServiceDiscovery::updateServiceInfo(const ServiceInfo &info)
+{
+    if (!mImpl->threadedPoll) {
+        return;
+    }
+
+    avahi_threaded_poll_lock(mImpl->threadedPoll);
+
+    mImpl->registeredInfo = info;
+    if (mImpl->entryGroup && !avahi_entry_group_is_empty(mImpl->entryGroup)) {
+        AvahiStringList *txt = mImpl->makeTxt();
+        avahi_entry_group_update_service_txt_strlst(mImpl->entryGroup,
+                                                    AVAHI_IF_UNSPEC,
+                                                    AVAHI_PROTO_UNSPEC,
+                                                    static_cast<AvahiPublishFlags>(0),
+                                                    mImpl->registeredName.c_str(),
+                                                    kServiceType,
+                                                    nullptr,
+                                                    txt);
+        avahi_string_list_free(txt);
+    }
+
+    avahi_threaded_poll_unlock(mImpl->threadedPoll);
+}
+
 void ServiceDiscovery::unregisterService()
 {
     if (!mImpl->threadedPoll) {
@@ -512,11 +538,6 @@ void ServiceDiscovery::stopBrowsing()
     avahi_threaded_poll_unlock(mImpl->threadedPoll);
 }
 
-void ServiceDiscovery::poll()
-{
-    // Avahi uses threaded poll, so no manual polling needed
-}
-
 std::vector<DiscoveredService> ServiceDiscovery::getDiscoveredServices() const
 {
     std::lock_guard<std::mutex> lock(mImpl->mutex);
@@ -556,11 +577,13 @@ void ServiceDiscovery::setCallbacks(ServiceDiscoveryCallbacks callbacks)
     mCallbacks = std::move(callbacks);
 }
 
-bool ServiceDiscovery::registerService(const std::string &name, int port, const std::string &instanceId)
+bool ServiceDiscovery::registerService(const std::string &name, int port, const std::string &instanceId,
+                                       const ServiceInfo &info)
 {
     (void)name;
     (void)port;
     (void)instanceId;
+    (void)info;
 
     if (mCallbacks.onError) {
         mCallbacks.onError("Service discovery not available (Avahi not found). Use --server=host to connect manually.");
@@ -568,6 +591,11 @@ bool ServiceDiscovery::registerService(const std::string &name, int port, const
     return false;
 }
 
+void ServiceDiscovery::updateServiceInfo(const ServiceInfo &info)
+{
+    (void)info;
+}
+
 void ServiceDiscovery::unregisterService()
 {
     mRegistered = false;
@@ -586,10 +614,6 @@ void ServiceDiscovery::stopBrowsing()
     mBrowsing = false;
 }
 
-void ServiceDiscovery::poll()
-{
-}
-
 std::vector<DiscoveredService> ServiceDiscovery::getDiscoveredServices() const
 {
     return {};
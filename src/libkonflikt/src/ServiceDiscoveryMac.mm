@@ -5,6 +5,7 @@
 #include <konflikt/ServiceDiscovery.h>
 
 #include <arpa/inet.h>
+#include <dispatch/dispatch.h>
 #include <dns_sd.h>
 #include <mutex>
 #include <netdb.h>
@@ -17,10 +18,14 @@ static const char *kServiceType = "_konflikt._tcp";
 
 struct ServiceDiscovery::Impl
 {
+    // Serial queue that runs all DNS-SD callbacks; refs are only created,
+    // updated and deallocated on it once attached
+    dispatch_queue_t queue { nullptr };
+
     DNSServiceRef registerRef { nullptr };
     DNSServiceRef browseRef { nullptr };
 
-    // Services being resolved
+    // Services being resolved (queue only)
     std::unordered_map<std::string, DNSServiceRef> resolveRefs;
 
     // Discovered services
@@ -106,8 +111,6 @@ void ServiceDiscovery::Impl::onBrowseResult(DNSServiceFlags flags, uint32_t inte
 
     if (flags & kDNSServiceFlagsAdd) {
         // Service found - need to resolve to get host and port
-        std::lock_guard<std::mutex> lock(mutex);
-
         // Check if already resolving
         if (resolveRefs.count(name) > 0) {
             return;
@@ -119,12 +122,11 @@ void ServiceDiscovery::Impl::onBrowseResult(DNSServiceFlags flags, uint32_t inte
                               konflikt::resolveCallback, this);
 
         if (err == kDNSServiceErr_NoError) {
+            DNSServiceSetDispatchQueue(resolveRef, queue);
             resolveRefs[name] = resolveRef;
         }
     } else {
         // Service removed
-        std::lock_guard<std::mutex> lock(mutex);
-
         // Cancel any pending resolve
         auto it = resolveRefs.find(name);
         if (it != resolveRefs.end()) {
@@ -133,7 +135,10 @@ void ServiceDiscovery::Impl::onBrowseResult(DNSServiceFlags flags, uint32_t inte
         }
 
         // Remove from discovered services
-        services.erase(name);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            services.erase(name);
+        }
 
         if (parent->mCallbacks.onServiceLost) {
             parent->mCallbacks.onServiceLost(name);
@@ -162,8 +167,12 @@ void ServiceDiscovery::Impl::onResolveResult(DNSServiceErrorType errorCode, cons
         name = fullnameStr;
     }
 
-    // Parse TXT record for instance ID
-    std::string instanceId;
+    DiscoveredService service;
+    service.name = name;
+    service.host = hosttarget;
+    service.port = ntohs(port);
+
+    // Parse TXT record for instance ID, version, capabilities and load
     if (txtLen > 0 && txtRecord) {
         const unsigned char *ptr = txtRecord;
         const unsigned char *end = txtRecord + txtLen;
@@ -179,31 +188,21 @@ void ServiceDiscovery::Impl::onResolveResult(DNSServiceErrorType errorCode, cons
             // Parse key=value
             size_t eq = entry.find('=');
             if (eq != std::string::npos) {
-                std::string key = entry.substr(0, eq);
-                std::string value = entry.substr(eq + 1);
-                if (key == "id") {
-                    instanceId = value;
-                }
+                parseServiceTxtEntry(entry.substr(0, eq), entry.substr(eq + 1), service);
             }
         }
     }
 
-    DiscoveredService service;
-    service.name = name;
-    service.host = hosttarget;
-    service.port = ntohs(port);
-    service.instanceId = instanceId;
-
     {
         std::lock_guard<std::mutex> lock(mutex);
         services[name] = service;
+    }
 
-        // Clean up resolve ref
-        auto it = resolveRefs.find(name);
-        if (it != resolveRefs.end()) {
-            DNSServiceRefDeallocate(it->second);
-            resolveRefs.erase(it);
-        }
+    // Clean up resolve ref
+    auto it = resolveRefs.find(name);
+    if (it != resolveRefs.end()) {
+        DNSServiceRefDeallocate(it->second);
+        resolveRefs.erase(it);
     }
 
     if (parent->mCallbacks.onServiceFound) {
@@ -215,12 +214,14 @@ ServiceDiscovery::ServiceDiscovery()
     : mImpl(std::make_unique<Impl>())
 {
     mImpl->parent = this;
+    mImpl->queue = dispatch_queue_create("konflikt.discovery", DISPATCH_QUEUE_SERIAL);
 }
 
 ServiceDiscovery::~ServiceDiscovery()
 {
     unregisterService();
     stopBrowsing();
+    dispatch_release(mImpl->queue);
 }
 
 void ServiceDiscovery::setCallbacks(ServiceDiscoveryCallbacks callbacks)
@@ -228,16 +229,27 @@ void ServiceDiscovery::setCallbacks(ServiceDiscoveryCallbacks callbacks)
     mCallbacks = std::move(callbacks);
 }
 
-bool ServiceDiscovery::registerService(const std::string &name, int port, const std::string &instanceId)
+static void buildTxtRecord(TXTRecordRef &txtRecord, const std::string &instanceId, const ServiceInfo &info)
+{
+    TXTRecordCreate(&txtRecord, 0, nullptr);
+    for (const std::string &entry : serviceTxtEntries(instanceId, info)) {
+        size_t eq = entry.find('=');
+        std::string key = entry.substr(0, eq);
+        std::string value = entry.substr(eq + 1);
+        TXTRecordSetValue(&txtRecord, key.c_str(), static_cast<uint8_t>(value.length()), value.c_str());
+    }
+}
+
+bool ServiceDiscovery::registerService(const std::string &name, int port, const std::string &instanceId,
+                                       const ServiceInfo &info)
 {
     if (mRegistered) {
         unregisterService();
     }
 
-    // Create TXT record with instance ID
+    // Create TXT record with instance ID, version, capabilities and load
     TXTRecordRef txtRecord;
-    TXTRecordCreate(&txtRecord, 0, nullptr);
-    TXTRecordSetValue(&txtRecord, "id", static_cast<uint8_t>(instanceId.length()), instanceId.c_str());
+    buildTxtRecord(txtRecord, instanceId, info);
 
     DNSServiceErrorType err = DNSServiceRegister(&mImpl->registerRef, 0, // flags
                                                  0,                       // interface index (0 = all)
@@ -256,6 +268,7 @@ bool ServiceDiscovery::registerService(const std::string &name, int port, const
         }
         return false;
     }
+    DNSServiceSetDispatchQueue(mImpl->registerRef, mImpl->queue);
 
     mImpl->registeredName = name;
     mImpl->registeredPort = port;
@@ -265,11 +278,35 @@ bool ServiceDiscovery::registerService(const std::string &name, int port, const
     return true;
 }
 
+void ServiceDiscovery::updateServiceInfo(const ServiceInfo &info)
+{
+    if (!mImpl->registerRef) {
+        return;
+    }
+
+    TXTRecordRef txtRecord;
+    buildTxtRecord(txtRecord, mImpl->registeredInstanceId, info);
+    __block DNSServiceErrorType err = kDNSServiceErr_NoError;
+    Impl *impl = mImpl.get();
+    dispatch_sync(impl->queue, ^{
+        err = DNSServiceUpdateRecord(impl->registerRef, nullptr, 0, TXTRecordGetLength(&txtRecord),
+                                     TXTRecordGetBytesPtr(&txtRecord), 0);
+    });
+    TXTRecordDeallocate(&txtRecord);
+
+    if (err != kDNSServiceErr_NoError && mCallbacks.onError) {
+        mCallbacks.onError("Failed to update service TXT record: " + std::to_string(err));
+    }
+}
+
 void ServiceDiscovery::unregisterService()
 {
     if (mImpl->registerRef) {
-        DNSServiceRefDeallocate(mImpl->registerRef);
-        mImpl->registerRef = nullptr;
+        Impl *impl = mImpl.get();
+        dispatch_sync(impl->queue, ^{
+            DNSServiceRefDeallocate(impl->registerRef);
+            impl->registerRef = nullptr;
+        });
     }
     mRegistered = false;
 }
@@ -292,6 +329,7 @@ bool ServiceDiscovery::startBrowsing()
         }
         return false;
     }
+    DNSServiceSetDispatchQueue(mImpl->browseRef, mImpl->queue);
 
     mBrowsing = true;
     return true;
@@ -299,73 +337,25 @@ bool ServiceDiscovery::startBrowsing()
 
 void ServiceDiscovery::stopBrowsing()
 {
-    std::lock_guard<std::mutex> lock(mImpl->mutex);
-
-    // Clean up all resolve refs
-    for (auto &[name, ref] : mImpl->resolveRefs) {
-        DNSServiceRefDeallocate(ref);
-    }
-    mImpl->resolveRefs.clear();
-
-    // Clean up browse ref
-    if (mImpl->browseRef) {
-        DNSServiceRefDeallocate(mImpl->browseRef);
-        mImpl->browseRef = nullptr;
-    }
-
-    mImpl->services.clear();
-    mBrowsing = false;
-}
-
-void ServiceDiscovery::poll()
-{
-    // Process registration events
-    if (mImpl->registerRef) {
-        int fd = DNSServiceRefSockFD(mImpl->registerRef);
-        if (fd >= 0) {
-            fd_set readfds;
-            FD_ZERO(&readfds);
-            FD_SET(fd, &readfds);
-
-            struct timeval tv = { 0, 0 }; // Non-blocking
-            if (select(fd + 1, &readfds, nullptr, nullptr, &tv) > 0) {
-                DNSServiceProcessResult(mImpl->registerRef);
-            }
+    // Runs after any callback already in flight, and none run afterwards
+    Impl *impl = mImpl.get();
+    dispatch_sync(impl->queue, ^{
+        // Clean up all resolve refs
+        for (auto &entry : impl->resolveRefs) {
+            DNSServiceRefDeallocate(entry.second);
         }
-    }
+        impl->resolveRefs.clear();
 
-    // Process browse events
-    if (mImpl->browseRef) {
-        int fd = DNSServiceRefSockFD(mImpl->browseRef);
-        if (fd >= 0) {
-            fd_set readfds;
-            FD_ZERO(&readfds);
-            FD_SET(fd, &readfds);
-
-            struct timeval tv = { 0, 0 }; // Non-blocking
-            if (select(fd + 1, &readfds, nullptr, nullptr, &tv) > 0) {
-                DNSServiceProcessResult(mImpl->browseRef);
-            }
+        // Clean up browse ref
+        if (impl->browseRef) {
+            DNSServiceRefDeallocate(impl->browseRef);
+            impl->browseRef = nullptr;
         }
-    }
+    });
 
-    // Process resolve events
-    {
-        std::lock_guard<std::mutex> lock(mImpl->mutex);
-        for (auto &[name, ref] : mImpl->resolveRefs) {
-            int fd = DNSServiceRefSockFD(ref);
-            if (fd >= 0) {
-                fd_set readfds;
-                FD_ZERO(&readfds);
-                FD_SET(fd, &readfds);
-
-                struct timeval tv = { 0, 0 }; // Non-blocking
-                if (select(fd + 1, &readfds, nullptr, nullptr, &tv) > 0) {
-                    DNSServiceProcessResult(ref);
-                }
-            }
-        }
-    }
+    std::lock_guard<std::mutex> lock(mImpl->mutex);
+    mImpl->services.clear();
+    mBrowsing = false;
 }
 
 std::vector<DiscoveredService> ServiceDiscovery::getDiscoveredServices() const
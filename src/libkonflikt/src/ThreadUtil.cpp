@@ -0,0 +1,176 @@
+#include "konflikt/ThreadUtil.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <pthread.h>
+#include <sched.h>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace konflikt {
+
+namespace {
+
+struct RegisteredThread
+{
+    std::string name;
+    ThreadOptions options;
+    std::string error;
+    long tid { 0 };
+};
+
+std::mutex sRegistryMutex;
+std::vector<RegisteredThread> sRegistry;
+
+void appendError(std::string &error, const std::string &message)
+{
+    if (!error.empty()) {
+        error += "; ";
+    }
+    error += message;
+}
+
+long currentThreadId()
+{
+#ifdef __linux__
+    return static_cast<long>(gettid());
+#else
+    return 0;
+#endif
+}
+
+void registerThread(const ThreadOptions &options, const std::string &error)
+{
+    std::lock_guard<std::mutex> lock(sRegistryMutex);
+    auto it = std::find_if(sRegistry.begin(), sRegistry.end(), [&](const RegisteredThread &thread) {
+        return thread.name == options.name;
+    });
+    if (it == sRegistry.end()) {
+        it = sRegistry.insert(sRegistry.end(), RegisteredThread {});
+    }
+    *it = { options.name, options, error, currentThreadId() };
+}
+
+} // namespace
+
+std::optional<ThreadPolicy> parseThreadPolicy(std::string_view name)
+{
+    if (name == "default" || name == "other") {
+        return ThreadPolicy::Default;
+    }
+    if (name == "fifo") {
+        return ThreadPolicy::Fifo;
+    }
+    if (name == "rr") {
+        return ThreadPolicy::RoundRobin;
+    }
+    return std::nullopt;
+}
+
+const char *threadPolicyName(ThreadPolicy policy)
+{
+    switch (policy) {
+    case ThreadPolicy::Fifo:
+        return "fifo";
+    case ThreadPolicy::RoundRobin:
+        return "rr";
+    case ThreadPolicy::Default:
+        break;
+    }
+    return "default";
+}
+
+bool applyThreadOptions(const ThreadOptions &options, std::string &error)
+{
+    error.clear();
+
+    if (!options.name.empty()) {
+        std::string name = options.name.substr(0, 15);
+#ifdef __APPLE__
+        pthread_setname_np(name.c_str());
+#else
+        pthread_setname_np(pthread_self(), name.c_str());
+#endif
+    }
+
+#ifdef __linux__
+    if (!options.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : options.cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &set);
+            }
+        }
+        int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (rc != 0) {
+            appendError(error, std::string("CPU affinity: ") + std::strerror(rc));
+        }
+    }
+#else
+    if (!options.cpus.empty()) {
+        appendError(error, "CPU affinity is not supported on this platform");
+    }
+#endif
+
+    if (options.policy != ThreadPolicy::Default) {
+        int policy = options.policy == ThreadPolicy::Fifo ? SCHED_FIFO : SCHED_RR;
+        sched_param param {};
+        param.sched_priority = std::clamp(options.priority, sched_get_priority_min(policy), sched_get_priority_max(policy));
+        int rc = pthread_setschedparam(pthread_self(), policy, &param);
+        if (rc != 0) {
+            appendError(error, std::string(threadPolicyName(options.policy)) + " priority " +
+                std::to_string(param.sched_priority) + ": " + std::strerror(rc));
+        }
+    } else if (options.nice != 0) {
+#ifdef __linux__
+        // On Linux the nice value is per thread
+        if (setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), options.nice) != 0) {
+            appendError(error, std::string("nice ") + std::to_string(options.nice) + ": " + std::strerror(errno));
+        }
+#else
+        appendError(error, "per-thread nice is not supported on this platform");
+#endif
+    }
+
+    if (!options.name.empty()) {
+        registerThread(options, error);
+    }
+
+    return error.empty();
+}
+
+std::vector<ThreadSchedStats> threadSchedStats()
+{
+    std::vector<RegisteredThread> threads;
+    {
+        std::lock_guard<std::mutex> lock(sRegistryMutex);
+        threads = sRegistry;
+    }
+
+    std::vector<ThreadSchedStats> result;
+    result.reserve(threads.size());
+    for (const RegisteredThread &thread : threads) {
+        ThreadSchedStats stats;
+        stats.name = thread.name;
+        stats.options = thread.options;
+        stats.error = thread.error;
+#ifdef __linux__
+        // Needs CONFIG_SCHED_INFO; the file is gone once the thread has exited
+        std::ifstream file("/proc/self/task/" + std::to_string(thread.tid) + "/schedstat");
+        if (!(file >> stats.runNs >> stats.waitNs >> stats.timeslices)) {
+            stats.runNs = stats.waitNs = stats.timeslices = 0;
+        }
+#endif
+        result.push_back(std::move(stats));
+    }
+    return result;
+}
+
+} // namespace konflikt
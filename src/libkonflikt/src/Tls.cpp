@@ -0,0 +1,74 @@
+#include "Tls.h"
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+namespace konflikt {
+
+namespace {
+
+// How long a session ticket can be used to resume (seconds)
+constexpr long TLS_SESSION_LIFETIME = 24 * 60 * 60;
+
+// Key exchange: X25519 is the cheapest; P-256 for peers without it
+constexpr const char *TLS_GROUPS = "X25519:P-256";
+
+constexpr const char *TLS13_AES_FIRST = "TLS_AES_128_GCM_SHA256:TLS_AES_256_GCM_SHA384:TLS_CHACHA20_POLY1305_SHA256";
+constexpr const char *TLS13_CHACHA_FIRST = "TLS_CHACHA20_POLY1305_SHA256:TLS_AES_128_GCM_SHA256:TLS_AES_256_GCM_SHA384";
+
+constexpr const char *TLS12_AES_FIRST =
+    "ECDHE-ECDSA-AES128-GCM-SHA256:ECDHE-RSA-AES128-GCM-SHA256:"
+    "ECDHE-ECDSA-AES256-GCM-SHA384:ECDHE-RSA-AES256-GCM-SHA384:"
+    "ECDHE-ECDSA-CHACHA20-POLY1305:ECDHE-RSA-CHACHA20-POLY1305";
+constexpr const char *TLS12_CHACHA_FIRST =
+    "ECDHE-ECDSA-CHACHA20-POLY1305:ECDHE-RSA-CHACHA20-POLY1305:"
+    "ECDHE-ECDSA-AES128-GCM-SHA256:ECDHE-RSA-AES128-GCM-SHA256:"
+    "ECDHE-ECDSA-AES256-GCM-SHA384:ECDHE-RSA-AES256-GCM-SHA384";
+
+} // namespace
+
+bool hasHardwareAes()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("aes");
+#elif defined(__aarch64__) && defined(__APPLE__)
+    return true;  // Every Apple Silicon core has the ARMv8 crypto extensions
+#elif defined(__aarch64__) && defined(__linux__)
+    return (getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+#else
+    return false;
+#endif
+}
+
+void configureTls(SSL_CTX *ctx)
+{
+    static const bool aes = hasHardwareAes();
+
+    SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+    SSL_CTX_set1_groups_list(ctx, TLS_GROUPS);
+    SSL_CTX_set_ciphersuites(ctx, aes ? TLS13_AES_FIRST : TLS13_CHACHA_FIRST);
+    SSL_CTX_set_cipher_list(ctx, aes ? TLS12_AES_FIRST : TLS12_CHACHA_FIRST);
+}
+
+void configureServerTls(SSL_CTX *ctx)
+{
+    configureTls(ctx);
+
+    SSL_CTX_set_options(ctx, SSL_OP_CIPHER_SERVER_PREFERENCE | SSL_OP_PRIORITIZE_CHACHA);
+
+    // TLS 1.2 clients resume by session id, TLS 1.3 clients by ticket
+    static const unsigned char sessionIdContext[] = "konflikt";
+    SSL_CTX_set_session_id_context(ctx, sessionIdContext, sizeof(sessionIdContext) - 1);
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+    SSL_CTX_sess_set_cache_size(ctx, 1024);
+    SSL_CTX_set_timeout(ctx, TLS_SESSION_LIFETIME);
+    SSL_CTX_clear_options(ctx, SSL_OP_NO_TICKET);
+
+    // Clients only keep the newest ticket, so the default of two wastes an encryption
+    SSL_CTX_set_num_tickets(ctx, 1);
+}
+
+} // namespace konflikt
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <openssl/ssl.h>
+
+namespace konflikt {
+
+/// True when the CPU has AES instructions, making AES-GCM faster than ChaCha20
+bool hasHardwareAes();
+
+/// Shared TLS settings for both ends
+/// TLS 1.2 or later, X25519 key exchange first and AEAD ciphers ordered by
+/// what is fastest on this CPU. Best effort: anything the linked OpenSSL
+/// rejects keeps its default.
+void configureTls(SSL_CTX *ctx);
+
+/// Server: honour the client's cipher order when it puts ChaCha20 first (no
+/// AES hardware on its side), cache sessions and issue one ticket per
+/// handshake so reconnects can skip the full key exchange.
+void configureServerTls(SSL_CTX *ctx);
+
+} // namespace konflikt
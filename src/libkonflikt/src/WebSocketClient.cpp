@@ -1,6 +1,9 @@
 #include "konflikt/WebSocketClient.h"
+#include "Tls.h"
+#include "WebSocketFrame.h"
 
 #include <libusockets.h>
+#include <openssl/ssl.h>
 
 #include <atomic>
 #include <cstring>
@@ -62,6 +65,13 @@ std::string generateWebSocketKey()
     return base64_encode(key, 16);
 }
 
+// SSL_CTX ex data slot pointing back at the client that owns the context
+int sessionOwnerIndex()
+{
+    static const int index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return index;
+}
+
 } // namespace
 
 struct WebSocketClient::Impl
@@ -70,8 +80,11 @@ struct WebSocketClient::Impl
     struct us_loop_t *loop { nullptr };
     struct us_socket_context_t *context { nullptr };
     struct us_socket_t *socket { nullptr };
+    int contextSSL { 0 };  // SSL mode the loop and context were created for
 
     std::thread clientThread;
+    ThreadOptions threadOptions;
+    std::string threadOptionsError;  // Guarded by mutex
     std::atomic<bool> running { false };
     std::atomic<bool> shouldStop { false };
 
@@ -88,13 +101,25 @@ struct WebSocketClient::Impl
     bool useSSL { false };
     WebSocketClientSSLConfig sslConfig;
 
+    // Newest session ticket from the server, offered on the next connect
+    SSL_SESSION *tlsSession { nullptr };
+    std::string tlsSessionHost;
+    int tlsSessionPort { 0 };
+
+    WebSocketConnectStats connectStats;  // Guarded by mutex
+
     WebSocketClientCallbacks callbacks;
     WebSocketState state { WebSocketState::Disconnected };
 
     // Receive buffer for partial frames
-    std::vector<char> receiveBuffer;
+    WebSocketFrameParser parser;
+    WebSocketFrame receivedFrame;  // Reused so its payload keeps its capacity
     bool handshakeComplete { false };
 
+    // Outgoing frame buffer and masking key source, reused for every send
+    std::vector<uint8_t> sendBuffer;
+    std::mt19937 maskGenerator { std::random_device {}() };
+
     // Connection timeout tracking
     std::chrono::steady_clock::time_point connectStartTime;
     static constexpr int CONNECTION_TIMEOUT_MS = 10000; // 10 seconds
@@ -112,142 +137,94 @@ struct WebSocketClient::Impl
         if (!socket)
             return;
 
-        std::vector<uint8_t> frame;
+        sendBuffer.clear();
 
         // FIN bit + opcode
-        frame.push_back(0x80 | opcode);
+        sendBuffer.push_back(0x80 | opcode);
 
         // Mask bit + payload length
         if (len < 126) {
-            frame.push_back(0x80 | static_cast<uint8_t>(len));
+            sendBuffer.push_back(0x80 | static_cast<uint8_t>(len));
         } else if (len < 65536) {
-            frame.push_back(0x80 | 126);
-            frame.push_back(static_cast<uint8_t>((len >> 8) & 0xFF));
-            frame.push_back(static_cast<uint8_t>(len & 0xFF));
+            sendBuffer.push_back(0x80 | 126);
+            sendBuffer.push_back(static_cast<uint8_t>((len >> 8) & 0xFF));
+            sendBuffer.push_back(static_cast<uint8_t>(len & 0xFF));
         } else {
-            frame.push_back(0x80 | 127);
+            sendBuffer.push_back(0x80 | 127);
             for (int i = 7; i >= 0; i--) {
-                frame.push_back(static_cast<uint8_t>((len >> (i * 8)) & 0xFF));
+                sendBuffer.push_back(static_cast<uint8_t>((len >> (i * 8)) & 0xFF));
             }
         }
 
         // Masking key (required for client-to-server)
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(0, 255);
+        uint32_t key = maskGenerator();
         uint8_t mask[4];
         for (int i = 0; i < 4; i++) {
-            mask[i] = static_cast<uint8_t>(dis(gen));
-            frame.push_back(mask[i]);
+            mask[i] = static_cast<uint8_t>(key >> (i * 8));
+            sendBuffer.push_back(mask[i]);
         }
 
         // Masked payload
         for (size_t i = 0; i < len; i++) {
-            frame.push_back(static_cast<uint8_t>(data[i]) ^ mask[i % 4]);
+            sendBuffer.push_back(static_cast<uint8_t>(data[i]) ^ mask[i % 4]);
         }
 
-        us_socket_write(useSSL ? 1 : 0, socket, reinterpret_cast<const char *>(frame.data()), static_cast<int>(frame.size()), 0);
+        us_socket_write(useSSL ? 1 : 0, socket, reinterpret_cast<const char *>(sendBuffer.data()), static_cast<int>(sendBuffer.size()), 0);
     }
 
     void processReceivedData(const char *data, int length)
     {
-        receiveBuffer.insert(receiveBuffer.end(), data, data + length);
+        parser.append(data, static_cast<size_t>(length));
 
         if (!handshakeComplete) {
-            // Look for end of HTTP headers
-            std::string bufStr(receiveBuffer.begin(), receiveBuffer.end());
-            size_t headerEnd = bufStr.find("\r\n\r\n");
-
-            if (headerEnd != std::string::npos) {
-                // Check for successful upgrade
-                if (bufStr.find("101") != std::string::npos &&
-                    bufStr.find("Upgrade") != std::string::npos) {
+            switch (parser.parseHandshake()) {
+                case HandshakeParseResult::NeedMore:
+                    return; // Wait for more data
+                case HandshakeParseResult::Rejected:
+                    state = WebSocketState::Error;
+                    if (callbacks.onError) {
+                        callbacks.onError(parser.error());
+                    }
+                    return;
+                case HandshakeParseResult::Accepted:
                     handshakeComplete = true;
                     state = WebSocketState::Connected;
                     lastActivityTime = std::chrono::steady_clock::now();
                     waitingForPong = false;
+                    recordConnectStats();
 
                     if (callbacks.onConnect) {
                         callbacks.onConnect();
                     }
-
-                    // Remove handshake from buffer
-                    receiveBuffer.erase(receiveBuffer.begin(), receiveBuffer.begin() + headerEnd + 4);
-                } else {
-                    state = WebSocketState::Error;
-                    if (callbacks.onError) {
-                        callbacks.onError("WebSocket handshake failed");
-                    }
-                    return;
-                }
-            } else {
-                return; // Wait for more data
+                    break;
             }
         }
 
         // Process WebSocket frames
-        while (receiveBuffer.size() >= 2) {
-            size_t offset = 0;
-            uint8_t byte0 = static_cast<uint8_t>(receiveBuffer[0]);
-            uint8_t byte1 = static_cast<uint8_t>(receiveBuffer[1]);
-
-            bool fin = (byte0 & 0x80) != 0;
-            uint8_t opcode = byte0 & 0x0F;
-            bool masked = (byte1 & 0x80) != 0;
-            uint64_t payloadLen = byte1 & 0x7F;
-
-            offset = 2;
-
-            if (payloadLen == 126) {
-                if (receiveBuffer.size() < 4)
-                    return;
-                payloadLen = (static_cast<uint64_t>(static_cast<uint8_t>(receiveBuffer[2])) << 8) |
-                    static_cast<uint64_t>(static_cast<uint8_t>(receiveBuffer[3]));
-                offset = 4;
-            } else if (payloadLen == 127) {
-                if (receiveBuffer.size() < 10)
-                    return;
-                payloadLen = 0;
-                for (int i = 0; i < 8; i++) {
-                    payloadLen = (payloadLen << 8) | static_cast<uint64_t>(static_cast<uint8_t>(receiveBuffer[2 + i]));
-                }
-                offset = 10;
+        WebSocketFrame &frame = receivedFrame;
+        while (true) {
+            FrameParseResult result = parser.next(frame);
+            if (result == FrameParseResult::NeedMore) {
+                return;
             }
-
-            uint8_t mask[4] = { 0, 0, 0, 0 };
-            if (masked) {
-                if (receiveBuffer.size() < offset + 4)
-                    return;
-                for (int i = 0; i < 4; i++) {
-                    mask[i] = static_cast<uint8_t>(receiveBuffer[offset + i]);
+            if (result == FrameParseResult::Error) {
+                state = WebSocketState::Error;
+                if (callbacks.onError) {
+                    callbacks.onError(parser.error());
                 }
-                offset += 4;
-            }
-
-            if (receiveBuffer.size() < offset + payloadLen)
-                return;
-
-            // Extract and unmask payload
-            std::string payload;
-            payload.reserve(payloadLen);
-            for (uint64_t i = 0; i < payloadLen; i++) {
-                char c = receiveBuffer[offset + i];
-                if (masked) {
-                    c ^= mask[i % 4];
+                parser.reset();
+                if (socket) {
+                    us_socket_close(useSSL ? 1 : 0, socket, 0, nullptr);
                 }
-                payload.push_back(c);
+                return;
             }
 
-            // Remove processed frame from buffer
-            receiveBuffer.erase(receiveBuffer.begin(), receiveBuffer.begin() + offset + payloadLen);
-
-            // Handle frame
-            (void)fin; // TODO: handle fragmented frames
-            switch (opcode) {
+            // Handle frame (the parser reassembles fragmented messages)
+            switch (frame.opcode) {
                 case 0x01: // Text frame
                 case 0x02: // Binary frame
                     if (callbacks.onMessage) {
-                        callbacks.onMessage(payload);
+                        callbacks.onMessage(frame.payload);
                     }
                     break;
                 case 0x08: // Close
@@ -256,10 +233,10 @@ struct WebSocketClient::Impl
                         sendFrame(0x08, nullptr, 0);
                         us_socket_close(useSSL ? 1 : 0, socket, 0, nullptr);
                     }
-                    break;
+                    return;
                 case 0x09: // Ping
                     // Send pong
-                    sendFrame(0x0A, payload.c_str(), payload.size());
+                    sendFrame(0x0A, frame.payload.c_str(), frame.payload.size());
                     break;
                 case 0x0A: // Pong
                     waitingForPong = false;
@@ -268,6 +245,48 @@ struct WebSocketClient::Impl
         }
     }
 
+    void recordConnectStats()
+    {
+        WebSocketConnectStats stats;
+        stats.connectMs = std::chrono::duration<double, std::milli>(lastActivityTime - connectStartTime).count();
+        stats.tls = useSSL;
+        if (useSSL && socket) {
+            if (auto *ssl = static_cast<SSL *>(us_socket_get_native_handle(1, socket))) {
+                stats.tlsResumed = SSL_session_reused(ssl) == 1;
+                stats.tlsVersion = SSL_get_version(ssl);
+                stats.tlsCipher = SSL_get_cipher_name(ssl);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        connectStats = std::move(stats);
+    }
+
+    void setTlsSession(SSL_SESSION *session)
+    {
+        if (tlsSession) {
+            SSL_SESSION_free(tlsSession);
+        }
+        tlsSession = session;
+    }
+
+    // TLS 1.3 tickets arrive after the handshake; keep the newest one
+    static int onNewTlsSession(SSL *ssl, SSL_SESSION *session)
+    {
+        auto *impl = static_cast<Impl *>(SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), sessionOwnerIndex()));
+        if (!impl) {
+            return 0;
+        }
+        impl->setTlsSession(session);
+        return 1;  // We took the reference
+    }
+
+    // The context extension holds a pointer to the owning Impl
+    static Impl *fromSocket(struct us_socket_t *s)
+    {
+        return *static_cast<Impl **>(us_socket_context_ext(gSSLMode, us_socket_context(gSSLMode, s)));
+    }
+
     // Static callbacks for uSockets
     static struct us_socket_t *onOpen(struct us_socket_t *s, int is_client, char *ip, int ip_length)
     {
@@ -275,9 +294,16 @@ struct WebSocketClient::Impl
         (void)ip;
         (void)ip_length;
 
-        Impl *impl = static_cast<Impl *>(us_socket_context_ext(gSSLMode, us_socket_context(gSSLMode, s)));
+        Impl *impl = fromSocket(s);
         impl->socket = s;
 
+        // The TLS handshake starts after this returns, so the ticket can still be offered
+        if (gSSLMode && impl->tlsSession) {
+            if (auto *ssl = static_cast<SSL *>(us_socket_get_native_handle(1, s))) {
+                SSL_set_session(ssl, impl->tlsSession);
+            }
+        }
+
         // Send WebSocket handshake
         impl->websocketKey = generateWebSocketKey();
         std::ostringstream request;
@@ -297,7 +323,7 @@ struct WebSocketClient::Impl
 
     static struct us_socket_t *onData(struct us_socket_t *s, char *data, int length)
     {
-        Impl *impl = static_cast<Impl *>(us_socket_context_ext(gSSLMode, us_socket_context(gSSLMode, s)));
+        Impl *impl = fromSocket(s);
         impl->lastActivityTime = std::chrono::steady_clock::now();
         impl->processReceivedData(data, length);
         return s;
@@ -305,7 +331,7 @@ struct WebSocketClient::Impl
 
     static struct us_socket_t *onWritable(struct us_socket_t *s)
     {
-        Impl *impl = static_cast<Impl *>(us_socket_context_ext(gSSLMode, us_socket_context(gSSLMode, s)));
+        Impl *impl = fromSocket(s);
 
         // Send queued messages
         std::lock_guard<std::mutex> lock(impl->mutex);
@@ -323,7 +349,7 @@ struct WebSocketClient::Impl
         (void)code;
         (void)reason;
 
-        Impl *impl = static_cast<Impl *>(us_socket_context_ext(gSSLMode, us_socket_context(gSSLMode, s)));
+        Impl *impl = fromSocket(s);
         impl->socket = nullptr;
         impl->handshakeComplete = false;
 
@@ -351,7 +377,7 @@ struct WebSocketClient::Impl
     {
         (void)code;
 
-        Impl *impl = static_cast<Impl *>(us_socket_context_ext(gSSLMode, us_socket_context(gSSLMode, s)));
+        Impl *impl = fromSocket(s);
         impl->state = WebSocketState::Error;
 
         if (impl->callbacks.onError) {
@@ -363,6 +389,13 @@ struct WebSocketClient::Impl
 
     void run()
     {
+        std::string error;
+        applyThreadOptions(threadOptions, error);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            threadOptionsError = error;
+        }
+
         running = true;
 
         while (!shouldStop) {
@@ -384,56 +417,24 @@ struct WebSocketClient::Impl
 
             state = WebSocketState::Connecting;
             handshakeComplete = false;
-            receiveBuffer.clear();
+            parser.reset();
             connectStartTime = std::chrono::steady_clock::now();
 
-            // Set thread-local SSL mode for callbacks
-            gSSLMode = useSSL ? 1 : 0;
-
-            // Create event loop
-            loop = us_create_loop(nullptr, [](struct us_loop_t *) {
-            }, [](struct us_loop_t *) {
-            }, [](struct us_loop_t *) {
-            }, sizeof(Impl *));
-
-            // Store our pointer in the loop extension
-            *static_cast<Impl **>(us_loop_ext(loop)) = this;
-
-            // Create socket context (SSL or non-SSL)
-            struct us_socket_context_options_t options = {};
-            if (useSSL) {
-                // For SSL, optionally set CA file for server verification
-                if (!sslConfig.caFile.empty()) {
-                    options.ca_file_name = sslConfig.caFile.c_str();
-                }
-                // Note: self-signed certs typically don't verify by default
-                context = us_create_socket_context(1, loop, sizeof(Impl *), options);
-            } else {
-                context = us_create_socket_context(0, loop, sizeof(Impl *), options);
+            // Tickets are only valid for the server that issued them
+            if (host != tlsSessionHost || port != tlsSessionPort) {
+                setTlsSession(nullptr);
+                tlsSessionHost = host;
+                tlsSessionPort = port;
             }
 
-            if (!context) {
+            if (!ensureContext()) {
                 state = WebSocketState::Error;
                 if (callbacks.onError) {
                     callbacks.onError("Failed to create socket context");
                 }
-                us_loop_free(loop);
-                loop = nullptr;
                 continue;
             }
 
-            // Store our pointer in the context extension
-            *static_cast<Impl **>(us_socket_context_ext(gSSLMode, context)) = this;
-
-            // Set up callbacks
-            us_socket_context_on_open(gSSLMode, context, onOpen);
-            us_socket_context_on_data(gSSLMode, context, onData);
-            us_socket_context_on_writable(gSSLMode, context, onWritable);
-            us_socket_context_on_close(gSSLMode, context, onClose);
-            us_socket_context_on_end(gSSLMode, context, onEnd);
-            us_socket_context_on_timeout(gSSLMode, context, onTimeout);
-            us_socket_context_on_connect_error(gSSLMode, context, onConnectError);
-
             // Connect (SSL or non-SSL)
             socket = us_socket_context_connect(gSSLMode, context, host.c_str(), port, nullptr, 0, 0);
 
@@ -442,10 +443,6 @@ struct WebSocketClient::Impl
                 if (callbacks.onError) {
                     callbacks.onError("Failed to initiate connection");
                 }
-                us_socket_context_free(gSSLMode, context);
-                us_loop_free(loop);
-                context = nullptr;
-                loop = nullptr;
                 continue;
             }
 
@@ -516,20 +513,88 @@ struct WebSocketClient::Impl
                 us_loop_run(loop);
             }
 
-            // Cleanup
-            if (context) {
-                us_socket_context_free(gSSLMode, context);
-                context = nullptr;
-            }
-            if (loop) {
-                us_loop_free(loop);
-                loop = nullptr;
-            }
             socket = nullptr;
         }
 
+        freeContext();
+        setTlsSession(nullptr);
         running = false;
     }
+
+    // The loop and socket context live across reconnects, so a TLS client
+    // keeps its SSL_CTX (and the CA file it loaded) and can resume sessions
+    bool ensureContext()
+    {
+        int ssl = useSSL ? 1 : 0;
+        if (context && contextSSL == ssl) {
+            return true;
+        }
+        freeContext();
+
+        // Set thread-local SSL mode for callbacks
+        gSSLMode = ssl;
+        contextSSL = ssl;
+
+        // Create event loop
+        loop = us_create_loop(nullptr, [](struct us_loop_t *) {
+        }, [](struct us_loop_t *) {
+        }, [](struct us_loop_t *) {
+        }, sizeof(Impl *));
+
+        // Store our pointer in the loop extension
+        *static_cast<Impl **>(us_loop_ext(loop)) = this;
+
+        // Create socket context (SSL or non-SSL)
+        struct us_socket_context_options_t options = {};
+        if (ssl) {
+            // For SSL, optionally set CA file for server verification
+            if (!sslConfig.caFile.empty()) {
+                options.ca_file_name = sslConfig.caFile.c_str();
+            }
+            // Note: self-signed certs typically don't verify by default
+        }
+        context = us_create_socket_context(ssl, loop, sizeof(Impl *), options);
+
+        if (!context) {
+            us_loop_free(loop);
+            loop = nullptr;
+            return false;
+        }
+
+        // Store our pointer in the context extension
+        *static_cast<Impl **>(us_socket_context_ext(ssl, context)) = this;
+
+        if (ssl) {
+            if (auto *sslContext = static_cast<SSL_CTX *>(us_socket_context_get_native_handle(1, context))) {
+                configureTls(sslContext);
+                SSL_CTX_set_ex_data(sslContext, sessionOwnerIndex(), this);
+                SSL_CTX_set_session_cache_mode(sslContext, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+                SSL_CTX_sess_set_new_cb(sslContext, onNewTlsSession);
+            }
+        }
+
+        // Set up callbacks
+        us_socket_context_on_open(ssl, context, onOpen);
+        us_socket_context_on_data(ssl, context, onData);
+        us_socket_context_on_writable(ssl, context, onWritable);
+        us_socket_context_on_close(ssl, context, onClose);
+        us_socket_context_on_end(ssl, context, onEnd);
+        us_socket_context_on_timeout(ssl, context, onTimeout);
+        us_socket_context_on_connect_error(ssl, context, onConnectError);
+        return true;
+    }
+
+    void freeContext()
+    {
+        if (context) {
+            us_socket_context_free(contextSSL, context);
+            context = nullptr;
+        }
+        if (loop) {
+            us_loop_free(loop);
+            loop = nullptr;
+        }
+    }
 };
 
 WebSocketClient::WebSocketClient()
@@ -559,6 +624,23 @@ void WebSocketClient::setSSL(const WebSocketClientSSLConfig &config)
     mImpl->sslConfig = config;
 }
 
+void WebSocketClient::setThreadOptions(ThreadOptions options)
+{
+    mImpl->threadOptions = std::move(options);
+}
+
+std::string WebSocketClient::threadOptionsError() const
+{
+    std::lock_guard<std::mutex> lock(mImpl->mutex);
+    return mImpl->threadOptionsError;
+}
+
+WebSocketConnectStats WebSocketClient::lastConnectStats() const
+{
+    std::lock_guard<std::mutex> lock(mImpl->mutex);
+    return mImpl->connectStats;
+}
+
 bool WebSocketClient::connect(const std::string &host, int port, const std::string &path)
 {
     mHost = host;
@@ -0,0 +1,180 @@
+#include "WebSocketFrame.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+namespace konflikt {
+
+void WebSocketFrameParser::append(const char *data, size_t length)
+{
+    // Reclaim consumed bytes before growing, so erase cost is amortized over many frames
+    if (mReadOffset > 0 && (mReadOffset == mBuffer.size() || mReadOffset >= mBuffer.size() / 2)) {
+        mBuffer.erase(mBuffer.begin(), mBuffer.begin() + static_cast<std::ptrdiff_t>(mReadOffset));
+        mHeaderSearchOffset -= std::min(mHeaderSearchOffset, mReadOffset);
+        mReadOffset = 0;
+    }
+    mBuffer.insert(mBuffer.end(), data, data + length);
+}
+
+HandshakeParseResult WebSocketFrameParser::parseHandshake()
+{
+    std::string_view buffered(mBuffer.data() + mReadOffset, mBuffer.size() - mReadOffset);
+
+    // Resume the terminator search where the last call stopped (minus a partial match)
+    size_t searchFrom = mHeaderSearchOffset > mReadOffset + 3 ? mHeaderSearchOffset - mReadOffset - 3 : 0;
+    size_t headerEnd = buffered.find("\r\n\r\n", searchFrom);
+
+    if (headerEnd == std::string_view::npos) {
+        if (buffered.size() > MAX_HANDSHAKE_SIZE) {
+            mError = "WebSocket handshake response too large";
+            return HandshakeParseResult::Rejected;
+        }
+        mHeaderSearchOffset = mBuffer.size();
+        return HandshakeParseResult::NeedMore;
+    }
+
+    std::string_view headers = buffered.substr(0, headerEnd);
+    size_t lineEnd = headers.find("\r\n");
+    std::string_view statusLine = headers.substr(0, lineEnd);
+
+    bool accepted = statusLine.find(" 101") != std::string_view::npos &&
+        headers.find("Upgrade") != std::string_view::npos;
+
+    consume(headerEnd + 4);
+    mHeaderSearchOffset = 0;
+
+    if (!accepted) {
+        mError = "WebSocket handshake failed";
+        return HandshakeParseResult::Rejected;
+    }
+    return HandshakeParseResult::Accepted;
+}
+
+FrameParseResult WebSocketFrameParser::next(WebSocketFrame &frame)
+{
+    while (true) {
+        const auto *data = reinterpret_cast<const uint8_t *>(mBuffer.data() + mReadOffset);
+        size_t available = mBuffer.size() - mReadOffset;
+
+        if (available < 2) {
+            return FrameParseResult::NeedMore;
+        }
+
+        bool fin = (data[0] & 0x80) != 0;
+        uint8_t opcode = data[0] & 0x0F;
+        bool masked = (data[1] & 0x80) != 0;
+        uint64_t payloadLen = data[1] & 0x7F;
+        size_t offset = 2;
+
+        if (payloadLen == 126) {
+            if (available < 4)
+                return FrameParseResult::NeedMore;
+            payloadLen = (static_cast<uint64_t>(data[2]) << 8) | static_cast<uint64_t>(data[3]);
+            offset = 4;
+        } else if (payloadLen == 127) {
+            if (available < 10)
+                return FrameParseResult::NeedMore;
+            payloadLen = 0;
+            for (int i = 0; i < 8; i++) {
+                payloadLen = (payloadLen << 8) | static_cast<uint64_t>(data[2 + i]);
+            }
+            offset = 10;
+        }
+
+        // Reject before waiting for (or allocating) the payload
+        if (payloadLen > MAX_PAYLOAD_SIZE) {
+            mError = "WebSocket frame too large (" + std::to_string(payloadLen) + " bytes)";
+            return FrameParseResult::Error;
+        }
+
+        // Control frames must be small and unfragmented (RFC 6455 5.5)
+        bool control = (opcode & 0x08) != 0;
+        if (control && (payloadLen > 125 || !fin)) {
+            mError = "Invalid WebSocket control frame";
+            return FrameParseResult::Error;
+        }
+
+        // Continuations only follow an unfinished message, which nothing else may interrupt
+        // but control frames (RFC 6455 5.4)
+        if (opcode == 0x00 && mMessageOpcode == 0) {
+            mError = "Unexpected WebSocket continuation frame";
+            return FrameParseResult::Error;
+        }
+        if (!control && opcode != 0x00 && mMessageOpcode != 0) {
+            mError = "WebSocket data frame inside a fragmented message";
+            return FrameParseResult::Error;
+        }
+        bool fragment = !control && (opcode == 0x00 || !fin);
+        if (fragment && payloadLen > MAX_PAYLOAD_SIZE - mMessage.size()) {
+            mError = "Fragmented WebSocket message too large";
+            return FrameParseResult::Error;
+        }
+
+        uint8_t mask[4] = { 0, 0, 0, 0 };
+        if (masked) {
+            if (available < offset + 4)
+                return FrameParseResult::NeedMore;
+            std::memcpy(mask, data + offset, 4);
+            offset += 4;
+        }
+
+        size_t length = static_cast<size_t>(payloadLen);
+        if (available - offset < length)
+            return FrameParseResult::NeedMore;
+
+        // Fragments collect in mMessage, anything else is returned as is
+        std::string &payload = fragment ? mMessage : frame.payload;
+        size_t start = fragment ? payload.size() : 0;
+        payload.resize(start + length);
+        std::memcpy(payload.data() + start, data + offset, length);
+        if (masked) {
+            for (size_t i = 0; i < length; i++) {
+                payload[start + i] = static_cast<char>(payload[start + i] ^ mask[i % 4]);
+            }
+        }
+        consume(offset + length);
+
+        if (!fragment) {
+            frame.fin = fin;
+            frame.opcode = opcode;
+            return FrameParseResult::Frame;
+        }
+
+        if (opcode != 0x00) {
+            mMessageOpcode = opcode;
+        }
+        if (!fin) {
+            continue;
+        }
+
+        // Last fragment: hand over the whole message
+        frame.fin = true;
+        frame.opcode = mMessageOpcode;
+        frame.payload.swap(mMessage);
+        mMessage.clear();
+        mMessageOpcode = 0;
+        return FrameParseResult::Frame;
+    }
+}
+
+void WebSocketFrameParser::reset()
+{
+    mBuffer.clear();
+    mReadOffset = 0;
+    mHeaderSearchOffset = 0;
+    mMessage.clear();
+    mMessageOpcode = 0;
+    mError.clear();
+}
+
+void WebSocketFrameParser::consume(size_t bytes)
+{
+    mReadOffset += bytes;
+    if (mReadOffset == mBuffer.size()) {
+        mBuffer.clear();
+        mReadOffset = 0;
+    }
+}
+
+} // namespace konflikt
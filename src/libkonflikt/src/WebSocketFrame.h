@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace konflikt {
+
+/// A decoded WebSocket frame
+struct WebSocketFrame
+{
+    uint8_t opcode {};
+    bool fin { true };
+    std::string payload;
+};
+
+/// Result of trying to consume the HTTP upgrade response
+enum class HandshakeParseResult
+{
+    NeedMore,
+    Accepted,
+    Rejected
+};
+
+/// Result of trying to extract the next frame
+enum class FrameParseResult
+{
+    NeedMore,
+    Frame,
+    Error
+};
+
+/// Incremental parser for the client side of a WebSocket connection
+///
+/// Input is untrusted: declared lengths are bounded before any allocation and
+/// consumed bytes are reclaimed in bulk, so parsing stays linear in input size.
+/// Fragmented messages are reassembled: next() returns only whole messages,
+/// with control frames passed through as they arrive in between.
+class WebSocketFrameParser
+{
+public:
+    /// Largest payload accepted from the server, per frame and per reassembled
+    /// message (matches the server's maxPayloadLength)
+    static constexpr uint64_t MAX_PAYLOAD_SIZE = 16 * 1024 * 1024;
+
+    /// Largest HTTP upgrade response accepted before giving up
+    static constexpr size_t MAX_HANDSHAKE_SIZE = 16 * 1024;
+
+    /// Append received bytes
+    void append(const char *data, size_t length);
+
+    /// Consume the HTTP upgrade response once its headers are complete
+    HandshakeParseResult parseHandshake();
+
+    /// Extract the next complete frame; Error means the stream is unusable
+    FrameParseResult next(WebSocketFrame &frame);
+
+    /// Drop all buffered data
+    void reset();
+
+    /// Description of the last parse error
+    const std::string &error() const { return mError; }
+
+    /// Number of buffered, unconsumed bytes
+    size_t buffered() const { return mBuffer.size() - mReadOffset; }
+
+private:
+    void consume(size_t bytes);
+
+    std::vector<char> mBuffer;
+    size_t mReadOffset { 0 };
+    size_t mHeaderSearchOffset { 0 };
+    std::string mMessage;          // Fragments received so far
+    uint8_t mMessageOpcode { 0 };  // Opcode of the unfinished message, 0 = none
+    std::string mError;
+};
+
+} // namespace konflikt
@@ -1,7 +1,10 @@
 #include "konflikt/WebSocketServer.h"
+#include "konflikt/HttpServer.h"
+#include "Tls.h"
 
 #include <App.h>
 #include <atomic>
+#include <future>
 #include <mutex>
 #include <thread>
 #include <unordered_set>
@@ -23,6 +26,7 @@ struct WebSocketServerImplT
 
     std::thread serverThread;
     std::atomic<bool> running { false };
+    std::promise<bool> listening;  // Set once listen() has succeeded or failed
     us_listen_socket_t *listenSocket { nullptr };
     uWS::Loop *loop { nullptr };
 
@@ -31,10 +35,86 @@ struct WebSocketServerImplT
 
     WebSocketServerCallbacks callbacks;
     WebSocketServerSSLConfig sslConfig;
+    const HttpServer *http { nullptr };
     int port { 0 };
 
+    static void writeResponse(uWS::HttpResponse<SSL> *res, const HttpResponse &response)
+    {
+        res->writeStatus(std::to_string(response.statusCode) + " " + response.statusMessage);
+        res->writeHeader("Content-Type", response.contentType);
+        for (const auto &[key, value] : response.headers) {
+            res->writeHeader(key, value);
+        }
+        res->end(response.body);
+    }
+
+    void addHttpRoutes(App &app)
+    {
+        // Serve static files
+        if (!http->staticPrefix().empty()) {
+            app.get(http->staticPrefix() + "*", [this](auto *res, auto *req) {
+                writeResponse(res, http->serveStaticFile(std::string(req->getUrl())));
+            });
+        }
+
+        // Redirect root to UI
+        app.get("/", [this](auto *res, auto * /*req*/) {
+            if (!http->staticPrefix().empty()) {
+                res->writeStatus("302 Found");
+                res->writeHeader("Location", http->staticPrefix());
+                res->end();
+            } else {
+                res->end("Konflikt Server");
+            }
+        });
+
+        // Custom routes
+        for (const auto &[key, handler] : http->routes()) {
+            // Parse method and path from key (format: "METHOD /path")
+            auto spacePos = key.find(' ');
+            if (spacePos == std::string::npos)
+                continue;
+
+            std::string method = key.substr(0, spacePos);
+            std::string path = key.substr(spacePos + 1);
+
+            auto routeHandler = [&handler](auto *res, auto *req) {
+                HttpRequest httpReq;
+                httpReq.method = std::string(req->getMethod());
+                httpReq.path = std::string(req->getUrl());
+                httpReq.query = std::string(req->getQuery());
+
+                // Get commonly used headers
+                auto contentType = req->getHeader("content-type");
+                if (!contentType.empty()) {
+                    httpReq.headers["content-type"] = std::string(contentType);
+                }
+                auto accept = req->getHeader("accept");
+                if (!accept.empty()) {
+                    httpReq.headers["accept"] = std::string(accept);
+                }
+
+                writeResponse(res, handler(httpReq));
+            };
+
+            if (method == "GET") {
+                app.get(path, routeHandler);
+            } else if (method == "POST") {
+                app.post(path, routeHandler);
+            } else if (method == "PUT") {
+                app.put(path, routeHandler);
+            } else if (method == "DELETE") {
+                app.del(path, routeHandler);
+            }
+        }
+    }
+
     void runWithApp(App &app, int requestedPort)
     {
+        if (http) {
+            addHttpRoutes(app);
+        }
+
         app.template ws<PerSocketData>("/ws", {
             .compression = uWS::DISABLED,
             .maxPayloadLength = 16 * 1024 * 1024,
@@ -53,7 +133,7 @@ struct WebSocketServerImplT
 
             .message = [this](WebSocket *ws, std::string_view message, uWS::OpCode /*opCode*/) {
                 if (callbacks.onMessage) {
-                    callbacks.onMessage(std::string(message), static_cast<void *>(ws));
+                    callbacks.onMessage(message, static_cast<void *>(ws));
                 }
             },
 
@@ -68,6 +148,9 @@ struct WebSocketServerImplT
             }
         });
 
+        // Set before start() returns so tasks can be posted right away
+        loop = uWS::Loop::get();
+
         app.listen(requestedPort, [this](us_listen_socket_t *socket) {
             if (socket) {
                 listenSocket = socket;
@@ -77,9 +160,9 @@ struct WebSocketServerImplT
                 // Failed to listen
                 port = 0;
             }
+            listening.set_value(socket != nullptr);
         });
 
-        loop = uWS::Loop::get();
         app.run();
 
         running = false;
@@ -95,6 +178,9 @@ struct WebSocketServerImplT
                 options.passphrase = sslConfig.passphrase.c_str();
             }
             App app(options);
+            if (!app.constructorFailed()) {
+                configureServerTls(static_cast<SSL_CTX *>(app.getNativeHandle()));
+            }
             runWithApp(app, requestedPort);
         } else {
             App app;
@@ -102,13 +188,13 @@ struct WebSocketServerImplT
         }
     }
 
-    void sendMessage(void *connection, const std::string &message)
+    void sendMessage(void *connection, std::string_view message)
     {
         auto *ws = static_cast<WebSocket *>(connection);
         ws->send(message, uWS::OpCode::TEXT);
     }
 
-    void broadcastMessage(const std::string &message)
+    void broadcastMessage(std::string_view message)
     {
         std::lock_guard<std::mutex> lock(connectionsMutex);
         for (auto *ws : connections) {
@@ -116,6 +202,32 @@ struct WebSocketServerImplT
         }
     }
 
+    void closeConnection(void *connection)
+    {
+        if (!loop) {
+            return;
+        }
+
+        // Sockets may only be touched on the loop thread, and this one may be gone by then
+        loop->defer([this, connection]() {
+            auto *ws = static_cast<WebSocket *>(connection);
+            {
+                std::lock_guard<std::mutex> lock(connectionsMutex);
+                if (!connections.contains(ws)) {
+                    return;
+                }
+            }
+            ws->close();
+        });
+    }
+
+    void post(std::function<void()> task)
+    {
+        if (loop) {
+            loop->defer(std::move(task));
+        }
+    }
+
     void closeAll()
     {
         std::lock_guard<std::mutex> lock(connectionsMutex);
@@ -142,6 +254,9 @@ struct WebSocketServer::Impl
 
     WebSocketServerCallbacks callbacks;
     WebSocketServerSSLConfig sslConfig;
+    const HttpServer *http { nullptr };
+    ThreadOptions threadOptions;
+    std::string threadOptionsError;
     std::thread serverThread;
     std::atomic<bool> running { false };
     int port { 0 };
@@ -152,34 +267,28 @@ struct WebSocketServer::Impl
             ssl = std::make_unique<WebSocketServerImplT<true>>();
             ssl->callbacks = callbacks;
             ssl->sslConfig = sslConfig;
+            ssl->http = http;
+            std::future<bool> listening = ssl->listening.get_future();
             serverThread = std::thread([this, requestedPort]() {
+                applyThreadOptions(threadOptions, threadOptionsError);
                 ssl->run(requestedPort);
             });
 
-            // Wait for server to start
-            while (!ssl->running && serverThread.joinable()) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                if (ssl->port == 0 && ssl->listenSocket == nullptr) {
-                    break;
-                }
-            }
-            running = ssl->running.load();
+            // Wait for the listen socket (loading the certificate can take a while)
+            running = listening.get();
             port = ssl->port;
         } else {
             nonSSL = std::make_unique<WebSocketServerImplT<false>>();
             nonSSL->callbacks = callbacks;
+            nonSSL->http = http;
+            std::future<bool> listening = nonSSL->listening.get_future();
             serverThread = std::thread([this, requestedPort]() {
+                applyThreadOptions(threadOptions, threadOptionsError);
                 nonSSL->run(requestedPort);
             });
 
-            // Wait for server to start
-            while (!nonSSL->running && serverThread.joinable()) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                if (nonSSL->port == 0 && nonSSL->listenSocket == nullptr) {
-                    break;
-                }
-            }
-            running = nonSSL->running.load();
+            // Wait for the listen socket
+            running = listening.get();
             port = nonSSL->port;
         }
     }
@@ -217,7 +326,7 @@ struct WebSocketServer::Impl
         }
     }
 
-    void send(void *connection, const std::string &message)
+    void send(void *connection, std::string_view message)
     {
         if (isSSL && ssl) {
             ssl->sendMessage(connection, message);
@@ -226,7 +335,7 @@ struct WebSocketServer::Impl
         }
     }
 
-    void broadcast(const std::string &message)
+    void broadcast(std::string_view message)
     {
         if (isSSL && ssl) {
             ssl->broadcastMessage(message);
@@ -235,6 +344,24 @@ struct WebSocketServer::Impl
         }
     }
 
+    void disconnect(void *connection)
+    {
+        if (isSSL && ssl) {
+            ssl->closeConnection(connection);
+        } else if (nonSSL) {
+            nonSSL->closeConnection(connection);
+        }
+    }
+
+    void post(std::function<void()> task)
+    {
+        if (isSSL && ssl) {
+            ssl->post(std::move(task));
+        } else if (nonSSL) {
+            nonSSL->post(std::move(task));
+        }
+    }
+
     size_t clientCount() const
     {
         if (isSSL && ssl) {
@@ -274,6 +401,16 @@ void WebSocketServer::setCallbacks(WebSocketServerCallbacks callbacks)
     mImpl->callbacks = std::move(callbacks);
 }
 
+void WebSocketServer::setHttpServer(const HttpServer *http)
+{
+    mImpl->http = http;
+}
+
+void WebSocketServer::setThreadOptions(ThreadOptions options)
+{
+    mImpl->threadOptions = std::move(options);
+}
+
 bool WebSocketServer::start()
 {
     if (mRunning) {
@@ -281,6 +418,7 @@ bool WebSocketServer::start()
     }
 
     mImpl->start(mPort);
+    mThreadOptionsError = mImpl->threadOptionsError;
 
     mRunning = mImpl->running;
     if (mRunning) {
@@ -299,16 +437,26 @@ void WebSocketServer::stop()
     mImpl->stop();
 }
 
-void WebSocketServer::send(void *connection, const std::string &message)
+void WebSocketServer::send(void *connection, std::string_view message)
 {
     mImpl->send(connection, message);
 }
 
-void WebSocketServer::broadcast(const std::string &message)
+void WebSocketServer::broadcast(std::string_view message)
 {
     mImpl->broadcast(message);
 }
 
+void WebSocketServer::disconnect(void *connection)
+{
+    mImpl->disconnect(connection);
+}
+
+void WebSocketServer::post(std::function<void()> task)
+{
+    mImpl->post(std::move(task));
+}
+
 size_t WebSocketServer::clientCount() const
 {
     return mImpl->clientCount();
@@ -1,15 +1,20 @@
 // Konflikt Linux CLI Application
 
 #include <konflikt/ConfigManager.h>
+#include <konflikt/KeyRemap.h>
 #include <konflikt/Konflikt.h>
 #include <konflikt/Version.h>
 
+#include <cmath>
 #include <csignal>
 #include <cstdlib>
 #include <cstring>
 #include <filesystem>
 #include <iostream>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 using konflikt::VERSION;
 
@@ -36,6 +41,7 @@ void printUsage(const char *programName)
               << "  --role=server|client  Run as server or client (default: server)\n"
               << "  --server=HOST         Server hostname (client auto-discovers if not set)\n"
               << "  --port=PORT           Port to use (default: 3000)\n"
+              << "  --max-clients=N       Refuse new clients beyond N (server, default: no limit)\n"
               << "  --config=PATH         Path to config file\n"
               << "  --ui-dir=PATH         Directory containing UI files\n"
               << "  --name=NAME           Display name for this machine\n"
@@ -52,6 +58,16 @@ void printUsage(const char *programName)
               << "  --remap-keys=PRESET   Key remapping preset: mac-to-linux, linux-to-mac\n"
               << "  --remap-key=FROM:TO   Custom key remap (keycodes, e.g., 55:133)\n"
               << "  --log-keycodes        Log pressed keycodes (for debugging key remaps)\n"
+              << "  --record-trace=PATH   Record captured input events to a trace file\n"
+              << "  --replay-trace=PATH   Replay a recorded input trace (server only)\n"
+              << "  --replay-speed=N      Trace replay speed multiplier, 0 = max (default: 1)\n"
+              << "  --pointer-speed=N     Pointer speed on remote screens (default: 1)\n"
+              << "  --pointer-accel=N     Pointer acceleration, 0 = off (default: 0)\n"
+              << "  --jitter-buffer=MS    Smooth bursty mouse motion, adding up to MS latency (client)\n"
+              << "  --THREAD-cpus=LIST    Pin a thread to these CPUs (e.g. --capture-cpus=2,3)\n"
+              << "  --THREAD-nice=N       Nice level for a thread (default: 0)\n"
+              << "  --THREAD-sched=POLICY Scheduling policy: fifo:PRIO, rr:PRIO or default\n"
+              << "                        THREAD is capture (input), network (server) or client\n"
               << "  --verbose             Enable verbose logging\n"
               << "  -v, --version         Show version information\n"
               << "  -h, --help            Show this help message\n"
@@ -66,6 +82,80 @@ void printVersion()
               << std::endl;
 }
 
+bool parseCpuList(const std::string &list, std::vector<int> &cpus)
+{
+    cpus.clear();
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        std::string item = list.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        try {
+            size_t used = 0;
+            int cpu = std::stoi(item, &used);
+            if (used != item.size() || cpu < 0) {
+                return false;
+            }
+            cpus.push_back(cpu);
+        } catch (...) {
+            return false;
+        }
+        if (comma == std::string::npos) {
+            break;
+        }
+        start = comma + 1;
+    }
+    return true;
+}
+
+// Parse --THREAD-cpus=, --THREAD-nice= and --THREAD-sched= for the capture,
+// network and client threads. Returns nullopt if arg is not such a flag.
+std::optional<bool> parseThreadFlag(const std::string &arg, konflikt::Config &config)
+{
+    const std::pair<const char *, konflikt::ThreadOptions *> threads[] = {
+        { "--capture-", &config.captureThread },
+        { "--network-", &config.networkThread },
+        { "--client-", &config.clientThread },
+    };
+
+    for (const auto &[prefix, options] : threads) {
+        if (arg.rfind(prefix, 0) != 0) {
+            continue;
+        }
+
+        std::string option = arg.substr(std::strlen(prefix));
+        if (option.rfind("cpus=", 0) == 0) {
+            return parseCpuList(option.substr(5), options->cpus);
+        }
+        if (option.rfind("nice=", 0) == 0) {
+            try {
+                options->nice = std::stoi(option.substr(5));
+            } catch (...) {
+                return false;
+            }
+            return options->nice >= -20 && options->nice <= 19;
+        }
+        if (option.rfind("sched=", 0) == 0) {
+            std::string value = option.substr(6);
+            size_t colon = value.find(':');
+            auto policy = konflikt::parseThreadPolicy(value.substr(0, colon));
+            if (!policy) {
+                return false;
+            }
+            options->policy = *policy;
+            options->priority = 0;
+            if (colon != std::string::npos) {
+                try {
+                    options->priority = std::stoi(value.substr(colon + 1));
+                } catch (...) {
+                    return false;
+                }
+            }
+            return *policy == konflikt::ThreadPolicy::Default || (options->priority >= 1 && options->priority <= 99);
+        }
+    }
+    return std::nullopt;
+}
+
 std::string getDefaultUiDir()
 {
     // Try various locations for the UI files
@@ -117,6 +207,9 @@ int main(int argc, char *argv[])
             (configPath.empty() ? konflikt::ConfigManager::getDefaultConfigPath() : configPath) << std::endl;
     }
 
+    // Watched for edits while running, even if it doesn't exist yet
+    config.configPath = configPath.empty() ? konflikt::ConfigManager::getDefaultConfigPath() : configPath;
+
     // Set defaults for anything not in config
     if (config.instanceName.empty()) {
         config.instanceName = "Linux";
@@ -151,6 +244,13 @@ int main(int argc, char *argv[])
             int port = std::stoi(arg.substr(7));
             config.port = port;
             config.serverPort = port;
+        } else if (arg.rfind("--max-clients=", 0) == 0) {
+            try {
+                config.maxClients = std::stoi(arg.substr(14));
+            } catch (...) {
+                std::cerr << "Error: Invalid max clients. Use a number (0 = no limit)." << std::endl;
+                return 1;
+            }
         } else if (arg.rfind("--ui-dir=", 0) == 0) {
             config.uiPath = arg.substr(9);
         } else if (arg.rfind("--name=", 0) == 0) {
@@ -179,25 +279,67 @@ int main(int argc, char *argv[])
             config.enableDebugApi = true;
         } else if (arg == "--log-keycodes") {
             config.logKeycodes = true;
+        } else if (arg.rfind("--record-trace=", 0) == 0) {
+            config.traceRecordFile = arg.substr(15);
+        } else if (arg.rfind("--replay-trace=", 0) == 0) {
+            config.traceReplayFile = arg.substr(15);
+        } else if (arg.rfind("--replay-speed=", 0) == 0) {
+            try {
+                config.traceReplaySpeed = std::stod(arg.substr(15));
+            } catch (...) {
+                std::cerr << "Error: Invalid replay speed. Use a number (0 = max speed)." << std::endl;
+                return 1;
+            }
+        } else if (arg.rfind("--pointer-speed=", 0) == 0) {
+            try {
+                double speed = std::stod(arg.substr(16));
+                if (!std::isfinite(speed) || speed <= 0) {
+                    throw std::out_of_range("pointer speed");
+                }
+                config.pointerSpeed = speed;
+            } catch (...) {
+                std::cerr << "Error: Invalid pointer speed. Use a positive number." << std::endl;
+                return 1;
+            }
+        } else if (arg.rfind("--pointer-accel=", 0) == 0) {
+            try {
+                double acceleration = std::stod(arg.substr(16));
+                if (!std::isfinite(acceleration) || acceleration < 0) {
+                    throw std::out_of_range("pointer acceleration");
+                }
+                config.pointerAcceleration = acceleration;
+            } catch (...) {
+                std::cerr << "Error: Invalid pointer acceleration. Use a number of 0 or more (0 = off)." << std::endl;
+                return 1;
+            }
+        } else if (arg.rfind("--jitter-buffer=", 0) == 0) {
+            try {
+                double jitterBufferMs = std::stod(arg.substr(16));
+                if (!std::isfinite(jitterBufferMs) || jitterBufferMs < 0) {
+                    throw std::out_of_range("jitter buffer");
+                }
+                config.jitterBufferMs = jitterBufferMs;
+            } catch (...) {
+                std::cerr << "Error: Invalid jitter buffer. Use milliseconds, 0 or more (e.g. 2, 0 = off)." << std::endl;
+                return 1;
+            }
+        } else if (auto parsed = parseThreadFlag(arg, config)) {
+            if (!*parsed) {
+                std::cerr << "Error: Invalid value for " << arg.substr(0, arg.find('=')) << ". "
+                          << "Use a CPU list (2,3), a nice level (-20 to 19) or a policy (fifo:N, rr:N, default)." << std::endl;
+                return 1;
+            }
         } else if (arg.rfind("--remap-keys=", 0) == 0) {
             std::string preset = arg.substr(13);
-            if (preset == "mac-to-linux") {
-                // Mac Command -> Linux Super, Mac Option -> Linux Alt
-                config.keyRemap[55] = 133;   // Command Left -> Super Left
-                config.keyRemap[54] = 134;   // Command Right -> Super Right
-                config.keyRemap[58] = 64;    // Option Left -> Alt Left
-                config.keyRemap[61] = 108;   // Option Right -> Alt Right
-            } else if (preset == "linux-to-mac") {
-                // Linux Super -> Mac Command, Linux Alt -> Mac Option
-                config.keyRemap[133] = 55;   // Super Left -> Command Left
-                config.keyRemap[134] = 54;   // Super Right -> Command Right
-                config.keyRemap[64] = 58;    // Alt Left -> Option Left
-                config.keyRemap[108] = 61;   // Alt Right -> Option Right
-            } else {
+            auto entries = konflikt::keyRemapPreset(preset);
+            if (entries.empty()) {
                 std::cerr << "Error: Unknown remap preset '" << preset << "'" << std::endl;
                 std::cerr << "Valid presets: mac-to-linux, linux-to-mac" << std::endl;
                 return 1;
             }
+            for (const auto &entry : entries) {
+                config.keyRemap[entry.from] = entry.to;
+            }
         } else if (arg.rfind("--remap-key=", 0) == 0) {
             std::string mapping = arg.substr(12);
             size_t colonPos = mapping.find(':');
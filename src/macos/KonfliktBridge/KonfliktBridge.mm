@@ -116,6 +116,7 @@
         if (config.logFile) {
             _config.logFile = [config.logFile UTF8String];
         }
+        _config.configPath = konflikt::ConfigManager::getDefaultConfigPath();
 
         _impl = std::make_unique<konflikt::Konflikt>(_config);
 
@@ -0,0 +1,177 @@
+// Konflikt allocation benchmark
+//
+// Counts heap allocations on the steady-state input path: encoding a mouse
+// move the way the server broadcasts it, and decoding it the way a client
+// receives it. After warm-up both must be allocation free; the exit status
+// is non-zero if they are not.
+//
+//   konflikt-allocbench --events=1000000
+
+#include <konflikt/Protocol.h>
+#include <konflikt/Version.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+using namespace konflikt;
+
+namespace {
+
+std::atomic<uint64_t> gAllocations { 0 };
+
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace {
+
+struct Options
+{
+    int events { 1000000 };
+    int warmup { 1000 };
+};
+
+/// Motion as the capture thread produces it: small deltas, a moving cursor
+InputEventData motion(int i)
+{
+    InputEventData data;
+    data.x = 100 + (i % 1800);
+    data.y = 100 + ((i * 7) % 1000);
+    data.dx = (i % 5) - 2;
+    data.dy = (i % 3) - 1;
+    data.timestamp = 1700000000000ull + static_cast<uint64_t>(i);
+    return data;
+}
+
+struct Result
+{
+    uint64_t allocations {};
+    double nsPerEvent {};
+    size_t bytes {};
+};
+
+Result run(int count, InputEventEncoder &encoder, InputEventMessage &received)
+{
+    Result result;
+    uint64_t before = gAllocations.load(std::memory_order_relaxed);
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < count; i++) {
+        std::string_view json = encoder.encode("mouseMove", motion(i));
+        if (json.empty() || !fromJson(json, received)) {
+            std::cerr << "Error: round trip failed at event " << i << std::endl;
+            std::exit(1);
+        }
+        result.bytes = json.size();
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    result.allocations = gAllocations.load(std::memory_order_relaxed) - before;
+    result.nsPerEvent = count > 0
+        ? static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / count
+        : 0.0;
+    return result;
+}
+
+void printUsage(const char *programName)
+{
+    std::cout << "Konflikt allocation benchmark v" << VERSION << "\n"
+              << "\n"
+              << "Usage: " << programName << " [OPTIONS]\n"
+              << "\n"
+              << "Options:\n"
+              << "  --events=N            Events measured after warm-up (default: 1000000)\n"
+              << "  --warmup=N            Events sent first to size the buffers (default: 1000)\n"
+              << "  -h, --help            Show this help message\n"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "-h" || arg == "--help") {
+                printUsage(argv[0]);
+                return 0;
+            } else if (arg.rfind("--events=", 0) == 0) {
+                options.events = std::stoi(arg.substr(9));
+            } else if (arg.rfind("--warmup=", 0) == 0) {
+                options.warmup = std::stoi(arg.substr(9));
+            } else {
+                std::cerr << "Error: Unknown option '" << arg << "'" << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (...) {
+        std::cerr << "Error: Invalid numeric option" << std::endl;
+        return 1;
+    }
+
+    if (options.events < 1 || options.warmup < 1) {
+        std::cerr << "Error: --events and --warmup must be positive" << std::endl;
+        return 1;
+    }
+
+    // The server names itself with the first handle it assigns
+    InstanceRegistry instances;
+    InputEventEncoder encoder;
+    encoder.setSource(instances.intern("allocbench"));
+    InputEventMessage received;
+
+    Result warmup = run(options.warmup, encoder, received);
+    Result steady = run(options.events, encoder, received);
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "warm-up: " << options.warmup << " events, " << warmup.allocations << " allocations\n"
+              << "steady:  " << options.events << " events, " << steady.allocations << " allocations, "
+              << steady.nsPerEvent << " ns/event, " << steady.bytes << " bytes/message" << std::endl;
+
+    if (steady.allocations != 0) {
+        std::cerr << "Error: steady-state motion allocated" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,603 @@
+// Konflikt load generator
+//
+// Spawns N protocol clients against a running server and ramps N up until
+// input delivery stops scaling. Drive the server with a recorded trace that
+// crosses into a remote screen, e.g.:
+//
+//   konflikt --replay-trace=session.kft --replay-speed=1 &
+//   konflikt-loadgen --server=localhost --server-pid=$!
+//
+// With --handshakes=N it instead times N connects with full TLS handshakes
+// (a fresh client each time) against N that resume the previous session:
+//
+//   konflikt --tls --tls-cert=cert.pem --tls-key=key.pem &
+//   konflikt-loadgen --tls --handshakes=200 --server-pid=$!
+
+#include <konflikt/Platform.h>
+#include <konflikt/Protocol.h>
+#include <konflikt/Version.h>
+#include <konflikt/WebSocketClient.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+using namespace konflikt;
+
+namespace {
+
+std::atomic<bool> gRunning { true };
+
+void signalHandler(int)
+{
+    gRunning = false;
+}
+
+struct Options
+{
+    std::string host { "localhost" };
+    int port { 3000 };
+    bool useTLS { false };
+    int startClients { 1 };
+    int maxClients { 256 };
+    int step { 8 };
+    int intervalSeconds { 5 };
+    int clipboardIntervalMs { 0 };  // 0 disables clipboard churn
+    int serverPid { 0 };            // Enables server CPU/RSS sampling
+    int handshakes { 0 };           // Time this many connects instead of ramping clients
+    double p99LimitMs { 20.0 };
+    double minDeliveryRatio { 0.99 };
+};
+
+/// Receive times for one broadcast message across all clients
+struct BroadcastSample
+{
+    uint64_t firstNs {};
+    uint64_t lastNs {};
+    int receivers {};
+};
+
+/// Whether host is this machine, so the server's monotonicNs() matches ours
+bool isLoopback(const std::string &host)
+{
+    return host == "localhost" || host == "::1" || host.starts_with("127.");
+}
+
+/// Broadcast spread tracking, keyed by message hash (every client receives identical bytes)
+class BroadcastTracker
+{
+public:
+    void record(const std::string &message)
+    {
+        uint64_t now = monotonicNs();
+        size_t key = std::hash<std::string> {}(message);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto &sample = mSamples[key];
+        if (sample.receivers == 0) {
+            sample.firstNs = now;
+        }
+        sample.lastNs = now;
+        sample.receivers++;
+    }
+
+    /// Spread (ms) of messages that reached all expected receivers, plus total message count
+    std::vector<double> takeSpreads(int expectedReceivers, size_t &messageCount)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::vector<double> spreads;
+        messageCount = mSamples.size();
+        for (const auto &[key, sample] : mSamples) {
+            if (sample.receivers >= expectedReceivers) {
+                spreads.push_back(static_cast<double>(sample.lastNs - sample.firstNs) / 1e6);
+            }
+        }
+        mSamples.clear();
+        return spreads;
+    }
+
+private:
+    std::mutex mMutex;
+    std::unordered_map<size_t, BroadcastSample> mSamples;
+};
+
+/// A lightweight protocol client: handshake, registration, heartbeats
+class LoadClient
+{
+public:
+    LoadClient(int index, const Options &options, BroadcastTracker &tracker)
+        : mTracker(tracker)
+        , mLocalServer(isLoopback(options.host))
+    {
+        mInstanceId = "loadgen-" + std::to_string(getpid()) + "-" + std::to_string(index);
+
+        if (options.useTLS) {
+            mClient.setSSL({});
+        }
+
+        mClient.setCallbacks({ .onConnect = [this]() {
+            HandshakeRequest req;
+            req.instanceId = mInstanceId;
+            req.instanceName = mInstanceId;
+            req.version = VERSION;
+            req.capabilities = { "input_events", "screen_info", "heartbeat" };
+            req.timestamp = timestamp();
+            mClient.send(toJson(req));
+        }, .onDisconnect = [this](const std::string &) {
+            mRegistered = false;
+        }, .onMessage = [this](const std::string &msg) {
+            onMessage(msg);
+        }, .onError = [](const std::string &) {} });
+
+        mClient.connect(options.host, options.port, "/ws");
+    }
+
+    bool registered() const { return mRegistered; }
+
+    void send(const std::string &message) { mClient.send(message); }
+
+    const std::string &instanceId() const { return mInstanceId; }
+
+    /// Take the latency samples (ms) collected since the last call
+    std::vector<double> takeLatencies()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::vector<double> out;
+        out.swap(mLatencies);
+        return out;
+    }
+
+private:
+    void onMessage(const std::string &msg)
+    {
+        auto type = getMessageType(msg);
+        if (!type) {
+            return;
+        }
+
+        if (*type == "input_event") {
+            mTracker.record(msg);
+            auto ev = fromJson<InputEventMessage>(msg);
+            std::optional<double> latency;
+            if (ev && mLocalServer && ev->eventData.sentNs != 0) {
+                // Same machine, same monotonic clock: sub-millisecond, immune to clock steps
+                uint64_t now = monotonicNs();
+                latency = now >= ev->eventData.sentNs
+                    ? static_cast<double>(now - ev->eventData.sentNs) / 1e6
+                    : 0.0;
+            } else if (ev && ev->eventData.timestamp != 0) {
+                uint64_t now = timestamp();
+                latency = now >= ev->eventData.timestamp
+                    ? static_cast<double>(now - ev->eventData.timestamp)
+                    : 0.0;
+            }
+            if (latency) {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mLatencies.push_back(*latency);
+            }
+        } else if (*type == "handshake_response") {
+            ClientRegistrationMessage reg;
+            reg.instanceId = mInstanceId;
+            reg.displayName = mInstanceId;
+            reg.machineId = mInstanceId;
+            reg.screenWidth = 1920;
+            reg.screenHeight = 1080;
+            mClient.send(toJson(reg));
+        } else if (*type == "layout_assignment") {
+            mRegistered = true;
+        } else if (*type == "heartbeat") {
+            // Echo like a real client, or the server closes us as unresponsive
+            auto hb = fromJson<HeartbeatMessage>(msg);
+            if (hb) {
+                HeartbeatMessage reply;
+                reply.instanceId = mInstanceId;
+                reply.seq = hb->seq;
+                reply.echoTimestamp = hb->timestamp;
+                reply.timestamp = timestamp();
+                mClient.send(toJson(reply));
+            }
+        }
+    }
+
+    BroadcastTracker &mTracker;
+    const bool mLocalServer;
+    std::string mInstanceId;
+    std::atomic<bool> mRegistered { false };
+    std::mutex mMutex;
+    std::vector<double> mLatencies;
+
+    // Declared last so its thread stops before the state it calls into is destroyed
+    WebSocketClient mClient;
+};
+
+/// CPU time (ticks) and resident set size (KB) for a process
+struct ProcessSample
+{
+    uint64_t cpuTicks {};
+    uint64_t rssKb {};
+    bool valid { false };
+};
+
+ProcessSample sampleProcess(int pid)
+{
+    ProcessSample sample;
+    if (pid <= 0) {
+        return sample;
+    }
+
+    std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
+    std::string line;
+    if (!std::getline(stat, line)) {
+        return sample;
+    }
+
+    // Fields after the command name (which may contain spaces); utime/stime are 14/15
+    size_t close = line.rfind(')');
+    if (close == std::string::npos) {
+        return sample;
+    }
+    std::istringstream fields(line.substr(close + 2));
+    std::string field;
+    uint64_t utime = 0, stime = 0;
+    for (int i = 3; i <= 15 && fields >> field; ++i) {
+        if (i == 14) {
+            utime = std::stoull(field);
+        } else if (i == 15) {
+            stime = std::stoull(field);
+        }
+    }
+    sample.cpuTicks = utime + stime;
+
+    std::ifstream status("/proc/" + std::to_string(pid) + "/status");
+    while (std::getline(status, line)) {
+        if (line.rfind("VmRSS:", 0) == 0) {
+            sample.rssKb = std::stoull(line.substr(6));
+            break;
+        }
+    }
+
+    sample.valid = true;
+    return sample;
+}
+
+double percentile(std::vector<double> &values, double p)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(p * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+    return values[index];
+}
+
+/// CPU time (ms) used by this process so far
+double selfCpuMs()
+{
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    auto toMs = [](const timeval &tv) {
+        return static_cast<double>(tv.tv_sec) * 1000.0 + static_cast<double>(tv.tv_usec) / 1000.0;
+    };
+    return toMs(usage.ru_utime) + toMs(usage.ru_stime);
+}
+
+/// Connect, wait for the upgrade and disconnect again; returns the connect stats
+std::optional<WebSocketConnectStats> connectOnce(WebSocketClient &client, const Options &options)
+{
+    client.connect(options.host, options.port, "/ws");
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (client.poll(), client.state() != WebSocketState::Connected) {
+        if (client.state() == WebSocketState::Error || std::chrono::steady_clock::now() > deadline) {
+            return std::nullopt;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    WebSocketConnectStats stats = client.lastConnectStats();
+
+    client.disconnect();
+    while (client.poll(), client.state() == WebSocketState::Connected) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    return stats;
+}
+
+/// Time full handshakes against resumed ones and print one row for each
+int runHandshakes(const Options &options)
+{
+    const long ticksPerSecond = sysconf(_SC_CLK_TCK);
+
+    std::cout << std::left
+              << std::setw(10) << "mode"
+              << std::setw(8) << "ok"
+              << std::setw(10) << "resumed"
+              << std::setw(9) << "p50ms"
+              << std::setw(9) << "p99ms"
+              << std::setw(12) << "cpu/conn"
+              << "server cpu/conn" << std::endl;
+
+    for (bool resume : { false, true }) {
+        std::vector<double> times;
+        int resumed = 0;
+        std::unique_ptr<WebSocketClient> client;
+        auto makeClient = [&]() {
+            client = std::make_unique<WebSocketClient>();
+            if (options.useTLS) {
+                client->setSSL({});
+            }
+        };
+
+        // Prime the session so every timed connect can resume
+        makeClient();
+        if (resume) {
+            connectOnce(*client, options);
+        }
+
+        ProcessSample serverBefore = sampleProcess(options.serverPid);
+        double cpuBefore = selfCpuMs();
+
+        for (int i = 0; gRunning && i < options.handshakes; ++i) {
+            if (!resume && i > 0) {
+                makeClient();
+            }
+            if (auto stats = connectOnce(*client, options)) {
+                times.push_back(stats->connectMs);
+                resumed += stats->tlsResumed ? 1 : 0;
+            }
+        }
+
+        double cpuMs = selfCpuMs() - cpuBefore;
+        ProcessSample serverAfter = sampleProcess(options.serverPid);
+        double count = static_cast<double>(std::max<size_t>(times.size(), 1));
+
+        std::cout << std::left << std::fixed << std::setprecision(2)
+                  << std::setw(10) << (resume ? "resumed" : "full")
+                  << std::setw(8) << times.size()
+                  << std::setw(10) << resumed
+                  << std::setw(9) << percentile(times, 0.50)
+                  << std::setw(9) << percentile(times, 0.99)
+                  << std::setw(12) << cpuMs / count;
+        if (serverBefore.valid && serverAfter.valid) {
+            double serverMs = static_cast<double>(serverAfter.cpuTicks - serverBefore.cpuTicks) * 1000.0 /
+                static_cast<double>(ticksPerSecond);
+            std::cout << serverMs / count;
+        } else {
+            std::cout << "-";
+        }
+        std::cout << std::endl;
+    }
+
+    if (!options.useTLS) {
+        std::cerr << "Note: without --tls there is no TLS session to resume" << std::endl;
+    }
+    return 0;
+}
+
+void printUsage(const char *programName)
+{
+    std::cout << "Konflikt load generator v" << VERSION << "\n"
+              << "\n"
+              << "Usage: " << programName << " [OPTIONS]\n"
+              << "\n"
+              << "Options:\n"
+              << "  --server=HOST         Server hostname (default: localhost)\n"
+              << "  --port=PORT           Server port (default: 3000)\n"
+              << "  --tls                 Connect using WSS\n"
+              << "  --clients=N           Initial number of clients (default: 1)\n"
+              << "  --max-clients=N       Stop ramping at N clients (default: 256)\n"
+              << "  --step=N              Clients added per step (default: 8)\n"
+              << "  --interval=SECONDS    Measurement time per step (default: 5)\n"
+              << "  --clipboard-ms=MS     Send clipboard updates every MS per client (default: off)\n"
+              << "  --server-pid=PID      Sample server CPU and memory from /proc\n"
+              << "  --p99-limit=MS        p99 delivery latency considered saturated (default: 20)\n"
+              << "  --handshakes=N        Time N full and N resumed connects, then exit\n"
+              << "  -h, --help            Show this help message\n"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "-h" || arg == "--help") {
+                printUsage(argv[0]);
+                return 0;
+            } else if (arg.rfind("--server=", 0) == 0) {
+                options.host = arg.substr(9);
+            } else if (arg.rfind("--port=", 0) == 0) {
+                options.port = std::stoi(arg.substr(7));
+            } else if (arg == "--tls") {
+                options.useTLS = true;
+            } else if (arg.rfind("--clients=", 0) == 0) {
+                options.startClients = std::stoi(arg.substr(10));
+            } else if (arg.rfind("--max-clients=", 0) == 0) {
+                options.maxClients = std::stoi(arg.substr(14));
+            } else if (arg.rfind("--step=", 0) == 0) {
+                options.step = std::stoi(arg.substr(7));
+            } else if (arg.rfind("--interval=", 0) == 0) {
+                options.intervalSeconds = std::stoi(arg.substr(11));
+            } else if (arg.rfind("--clipboard-ms=", 0) == 0) {
+                options.clipboardIntervalMs = std::stoi(arg.substr(15));
+            } else if (arg.rfind("--server-pid=", 0) == 0) {
+                options.serverPid = std::stoi(arg.substr(13));
+            } else if (arg.rfind("--p99-limit=", 0) == 0) {
+                options.p99LimitMs = std::stod(arg.substr(12));
+            } else if (arg.rfind("--handshakes=", 0) == 0) {
+                options.handshakes = std::stoi(arg.substr(13));
+            } else {
+                std::cerr << "Error: Unknown option '" << arg << "'" << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (...) {
+        std::cerr << "Error: Invalid numeric option" << std::endl;
+        return 1;
+    }
+
+    if (options.startClients < 1 || options.step < 1 || options.intervalSeconds < 1) {
+        std::cerr << "Error: --clients, --step and --interval must be positive" << std::endl;
+        return 1;
+    }
+
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+
+    if (options.handshakes > 0) {
+        return runHandshakes(options);
+    }
+
+    BroadcastTracker tracker;
+    std::vector<std::unique_ptr<LoadClient>> clients;
+    const long ticksPerSecond = sysconf(_SC_CLK_TCK);
+
+    ProcessSample baseline = sampleProcess(options.serverPid);
+    if (options.serverPid > 0 && !baseline.valid) {
+        std::cerr << "Warning: cannot read /proc/" << options.serverPid << ", server metrics disabled" << std::endl;
+    }
+
+    std::cout << std::left
+              << std::setw(8) << "clients"
+              << std::setw(10) << "events"
+              << std::setw(10) << "deliv%"
+              << std::setw(9) << "p50ms"
+              << std::setw(9) << "p99ms"
+              << std::setw(9) << "maxms"
+              << std::setw(11) << "spread99"
+              << std::setw(8) << "cpu%"
+              << std::setw(10) << "rssKB"
+              << "KB/conn" << std::endl;
+
+    int saturatedAt = 0;
+    std::string saturationReason;
+    uint32_t clipboardSequence = 0;
+
+    for (int target = options.startClients; gRunning && target <= options.maxClients; target += options.step) {
+        while (static_cast<int>(clients.size()) < target) {
+            clients.push_back(std::make_unique<LoadClient>(static_cast<int>(clients.size()), options, tracker));
+        }
+
+        // Wait for every client to finish registration
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (gRunning && std::chrono::steady_clock::now() < deadline &&
+               !std::all_of(clients.begin(), clients.end(), [](const auto &c) { return c->registered(); })) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        int registered = static_cast<int>(std::count_if(clients.begin(), clients.end(), [](const auto &c) { return c->registered(); }));
+        if (registered < target) {
+            saturatedAt = target;
+            saturationReason = std::to_string(target - registered) + " clients failed to register";
+            break;
+        }
+
+        // Drop anything received during ramp-up
+        size_t ignored = 0;
+        tracker.takeSpreads(target, ignored);
+        for (auto &client : clients) {
+            client->takeLatencies();
+        }
+
+        ProcessSample before = sampleProcess(options.serverPid);
+        auto start = std::chrono::steady_clock::now();
+        auto end = start + std::chrono::seconds(options.intervalSeconds);
+        auto nextClipboard = start;
+
+        while (gRunning && std::chrono::steady_clock::now() < end) {
+            auto now = std::chrono::steady_clock::now();
+            if (options.clipboardIntervalMs > 0 && now >= nextClipboard) {
+                for (auto &client : clients) {
+                    ClipboardSyncMessage cs;
+                    cs.sourceInstanceId = client->instanceId();
+                    cs.format = "text/plain";
+                    cs.data = client->instanceId() + " " + std::to_string(clipboardSequence);
+                    cs.sequence = ++clipboardSequence;
+                    cs.timestamp = timestamp();
+                    client->send(toJson(cs));
+                }
+                nextClipboard += std::chrono::milliseconds(options.clipboardIntervalMs);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        ProcessSample after = sampleProcess(options.serverPid);
+
+        std::vector<double> latencies;
+        for (auto &client : clients) {
+            auto samples = client->takeLatencies();
+            latencies.insert(latencies.end(), samples.begin(), samples.end());
+        }
+        size_t messages = 0;
+        std::vector<double> spreads = tracker.takeSpreads(target, messages);
+
+        size_t expected = messages * static_cast<size_t>(target);
+        double delivery = expected > 0 ? static_cast<double>(latencies.size()) / static_cast<double>(expected) : 1.0;
+        double p50 = percentile(latencies, 0.50);
+        double p99 = percentile(latencies, 0.99);
+        double maxLatency = latencies.empty() ? 0.0 : *std::max_element(latencies.begin(), latencies.end());
+        double spread99 = percentile(spreads, 0.99);
+
+        std::cout << std::left << std::fixed << std::setprecision(1)
+                  << std::setw(8) << target
+                  << std::setw(10) << messages
+                  << std::setw(10) << delivery * 100.0
+                  << std::setw(9) << p50
+                  << std::setw(9) << p99
+                  << std::setw(9) << maxLatency
+                  << std::setw(11) << spread99;
+        if (before.valid && after.valid) {
+            double cpu = static_cast<double>(after.cpuTicks - before.cpuTicks) * 100.0 /
+                (static_cast<double>(ticksPerSecond) * elapsed);
+            double perConn = after.rssKb > baseline.rssKb
+                ? static_cast<double>(after.rssKb - baseline.rssKb) / static_cast<double>(target)
+                : 0.0;
+            std::cout << std::setw(8) << cpu << std::setw(10) << after.rssKb << perConn;
+        } else {
+            std::cout << std::setw(8) << "-" << std::setw(10) << "-" << "-";
+        }
+        std::cout << std::endl;
+
+        if (messages == 0) {
+            std::cerr << "Warning: no input events received; is the server replaying a trace into a remote screen?" << std::endl;
+        }
+
+        if (p99 > options.p99LimitMs) {
+            saturatedAt = target;
+            saturationReason = "p99 latency " + std::to_string(p99) + "ms exceeds limit";
+            break;
+        }
+        if (messages > 0 && delivery < options.minDeliveryRatio) {
+            saturatedAt = target;
+            saturationReason = "only " + std::to_string(delivery * 100.0) + "% of events delivered";
+            break;
+        }
+    }
+
+    std::cout << std::endl;
+    if (saturatedAt > 0) {
+        std::cout << "Stopped scaling at " << saturatedAt << " clients: " << saturationReason << std::endl;
+    } else {
+        std::cout << "No saturation up to " << clients.size() << " clients" << std::endl;
+    }
+
+    return saturatedAt > 0 ? 2 : 0;
+}